@@ -0,0 +1,234 @@
+#include "atomic_fraction.hpp"
+namespace tokox
+{
+
+template <Fraction_compatible T>
+atomic_fraction<T>::atomic_fraction (const Fraction<T>& f):
+	_value(pack(f))
+{}
+
+template <Fraction_compatible T>
+bool atomic_fraction<T>::is_lock_free () const noexcept
+{
+	return _value.is_lock_free();
+}
+
+
+
+template <Fraction_compatible T>
+Fraction<T> atomic_fraction<T>::load (const std::memory_order order) const
+{
+	return unpack(_value.load(order));
+}
+
+template <Fraction_compatible T>
+void atomic_fraction<T>::store (const Fraction<T>& f, const std::memory_order order)
+{
+	_value.store(pack(f), order);
+}
+
+template <Fraction_compatible T>
+Fraction<T> atomic_fraction<T>::exchange (const Fraction<T>& f, const std::memory_order order)
+{
+	return unpack(_value.exchange(pack(f), order));
+}
+
+template <Fraction_compatible T>
+bool atomic_fraction<T>::compare_exchange_weak (Fraction<T>& expected, const Fraction<T>& desired,
+	const std::memory_order success, const std::memory_order failure)
+{
+	Packed e = pack(expected);
+	const bool exchanged = _value.compare_exchange_weak(e, pack(desired), success, failure);
+	expected = unpack(e);
+	return exchanged;
+}
+
+template <Fraction_compatible T>
+bool atomic_fraction<T>::compare_exchange_weak (Fraction<T>& expected, const Fraction<T>& desired, const std::memory_order order)
+{
+	return compare_exchange_weak(expected, desired, order, failure_order(order));
+}
+
+template <Fraction_compatible T>
+bool atomic_fraction<T>::compare_exchange_strong (Fraction<T>& expected, const Fraction<T>& desired,
+	const std::memory_order success, const std::memory_order failure)
+{
+	Packed e = pack(expected);
+	const bool exchanged = _value.compare_exchange_strong(e, pack(desired), success, failure);
+	expected = unpack(e);
+	return exchanged;
+}
+
+template <Fraction_compatible T>
+bool atomic_fraction<T>::compare_exchange_strong (Fraction<T>& expected, const Fraction<T>& desired, const std::memory_order order)
+{
+	return compare_exchange_strong(expected, desired, order, failure_order(order));
+}
+
+
+
+template <Fraction_compatible T>
+Fraction<T> atomic_fraction<T>::fetch_add (const Fraction<T>& f, const std::memory_order order)
+{
+	return update([&f] (Fraction<T>& v) { v += f; }, order);
+}
+
+template <Fraction_compatible T>
+Fraction<T> atomic_fraction<T>::fetch_sub (const Fraction<T>& f, const std::memory_order order)
+{
+	return update([&f] (Fraction<T>& v) { v -= f; }, order);
+}
+
+template <Fraction_compatible T>
+Fraction<T> atomic_fraction<T>::fetch_mul (const Fraction<T>& f, const std::memory_order order)
+{
+	return update([&f] (Fraction<T>& v) { v *= f; }, order);
+}
+
+
+
+template <Fraction_compatible T>
+atomic_fraction<T>::operator Fraction<T> () const
+{
+	return load();
+}
+
+template <Fraction_compatible T>
+Fraction<T> atomic_fraction<T>::operator= (const Fraction<T>& f)
+{
+	store(f);
+	return f;
+}
+
+template <Fraction_compatible T>
+Fraction<T> atomic_fraction<T>::operator+= (const Fraction<T>& f)
+{
+	return fetch_add(f) + f;
+}
+
+template <Fraction_compatible T>
+Fraction<T> atomic_fraction<T>::operator-= (const Fraction<T>& f)
+{
+	return fetch_sub(f) - f;
+}
+
+template <Fraction_compatible T>
+Fraction<T> atomic_fraction<T>::operator*= (const Fraction<T>& f)
+{
+	return fetch_mul(f) * f;
+}
+
+
+
+template <Fraction_compatible T>
+template <typename Op>
+Fraction<T> atomic_fraction<T>::update (Op op, const std::memory_order order)
+{
+	Packed current = _value.peek();
+	bool validated = false;
+	while (true)
+	{
+		Fraction<T> next = unpack(current);
+		try
+		{
+			op(next);
+		}
+		catch (...)
+		{
+			// A torn first guess can overflow where the real value does not.
+			if (validated)
+			{
+				throw;
+			}
+			current = _value.load(std::memory_order_relaxed);
+			validated = true;
+			continue;
+		}
+		if (_value.compare_exchange_weak(current, pack(next), order, failure_order(order)))
+		{
+			return unpack(current);
+		}
+		validated = true;
+	}
+}
+
+template <Fraction_compatible T>
+typename atomic_fraction<T>::Packed atomic_fraction<T>::pack (const Fraction<T>& f)
+{
+	f.reduce();
+	Packed p;
+	p.numerator = f.numerator();
+	p.denominator = f.denominator();
+	return p;
+}
+
+template <Fraction_compatible T>
+Fraction<T> atomic_fraction<T>::unpack (const Packed& p)
+{
+	return Fraction<T>::from_reduced(p.numerator, p.denominator);
+}
+
+template <Fraction_compatible T>
+std::memory_order atomic_fraction<T>::failure_order (const std::memory_order order)
+{
+	switch (order)
+	{
+		case std::memory_order_acq_rel:
+			return std::memory_order_acquire;
+		case std::memory_order_release:
+			return std::memory_order_relaxed;
+		default:
+			return order;
+	}
+}
+
+
+
+template <Fraction_compatible T, std::size_t Shards>
+sharded_atomic_fraction<T, Shards>::sharded_atomic_fraction (const Fraction<T>& f)
+{
+	store(f);
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+void sharded_atomic_fraction<T, Shards>::add (const Fraction<T>& f, const std::memory_order order)
+{
+	_shards[shard_index()].value.fetch_add(f, order);
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+void sharded_atomic_fraction<T, Shards>::sub (const Fraction<T>& f, const std::memory_order order)
+{
+	_shards[shard_index()].value.fetch_sub(f, order);
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+Fraction<T> sharded_atomic_fraction<T, Shards>::load (const std::memory_order order) const
+{
+	Fraction<T> sum;
+	for (const Shard& s : _shards)
+	{
+		sum += s.value.load(order);
+	}
+	return sum;
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+void sharded_atomic_fraction<T, Shards>::store (const Fraction<T>& f, const std::memory_order order)
+{
+	_shards[0].value.store(f, order);
+	for (std::size_t i = 1; i < Shards; ++i)
+	{
+		_shards[i].value.store(Fraction<T>(), order);
+	}
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+std::size_t sharded_atomic_fraction<T, Shards>::shard_index ()
+{
+	static std::atomic<std::size_t> next(0);
+	thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % Shards;
+	return index;
+}
+
+}
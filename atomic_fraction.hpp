@@ -0,0 +1,265 @@
+#ifndef TOKOX_FRACTIONS_ATOMIC_FRACTION
+#define TOKOX_FRACTIONS_ATOMIC_FRACTION
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <type_traits>
+
+#include "fractions.hpp"
+
+namespace tokox
+{
+
+namespace detail
+{
+
+template <typename T>
+struct PackedFraction
+{
+	T numerator;
+	T denominator;
+};
+
+// std::atomic of a 16 byte struct goes through libatomic and is not reported
+// as lock-free, so with cmpxchg16b available (-mcx16) the pair is kept in an
+// unsigned __int128 and updated with the __sync builtins instead. x86-64 has no
+// plain 16 byte atomic load the compiler will emit inline, so load() is a
+// compare-and-swap of the value with itself: every reader writes, takes the
+// cache line exclusively and contends with the writers, and the storage is
+// mutable and cannot live in read-only memory. The CAS loops only need a
+// starting guess and seed themselves with peek(), two relaxed 8 byte loads
+// that may be torn but never race, instead.
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16) && defined(__SIZEOF_INT128__)
+inline constexpr bool has_cas16 = true;
+#else
+inline constexpr bool has_cas16 = false;
+#endif
+
+template <typename P, bool Wide = (has_cas16 && sizeof(P) == 16)>
+class AtomicStorage
+{
+public:
+	explicit AtomicStorage (const P p):
+		_value(p)
+	{}
+
+	static constexpr bool is_always_lock_free = std::atomic<P>::is_always_lock_free;
+
+	bool is_lock_free () const noexcept
+	{
+		return _value.is_lock_free();
+	}
+
+	P load (const std::memory_order order) const noexcept
+	{
+		return _value.load(order);
+	}
+
+	P peek () const noexcept
+	{
+		return _value.load(std::memory_order_relaxed);
+	}
+
+	void store (const P p, const std::memory_order order) noexcept
+	{
+		_value.store(p, order);
+	}
+
+	P exchange (const P p, const std::memory_order order) noexcept
+	{
+		return _value.exchange(p, order);
+	}
+
+	bool compare_exchange_weak (P& expected, const P desired, const std::memory_order success, const std::memory_order failure) noexcept
+	{
+		return _value.compare_exchange_weak(expected, desired, success, failure);
+	}
+
+	bool compare_exchange_strong (P& expected, const P desired, const std::memory_order success, const std::memory_order failure) noexcept
+	{
+		return _value.compare_exchange_strong(expected, desired, success, failure);
+	}
+
+private:
+	std::atomic<P> _value;
+};
+
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16) && defined(__SIZEOF_INT128__)
+template <typename P>
+class AtomicStorage<P, true>
+{
+public:
+	explicit AtomicStorage (const P p):
+		_raw(to_raw(p))
+	{}
+
+	static constexpr bool is_always_lock_free = true;
+
+	bool is_lock_free () const noexcept
+	{
+		return true;
+	}
+
+	P load (const std::memory_order) const noexcept
+	{
+		return from_raw(__sync_val_compare_and_swap(&_raw, 0, 0));
+	}
+
+	P peek () const noexcept
+	{
+		return from_raw(peek_raw());
+	}
+
+	void store (const P p, const std::memory_order order) noexcept
+	{
+		exchange(p, order);
+	}
+
+	P exchange (const P p, const std::memory_order) noexcept
+	{
+		const unsigned __int128 desired = to_raw(p);
+		unsigned __int128 current = peek_raw();
+		while (true)
+		{
+			const unsigned __int128 previous = __sync_val_compare_and_swap(&_raw, current, desired);
+			if (previous == current)
+			{
+				return from_raw(previous);
+			}
+			current = previous;
+		}
+	}
+
+	bool compare_exchange_weak (P& expected, const P desired, const std::memory_order success, const std::memory_order failure) noexcept
+	{
+		return compare_exchange_strong(expected, desired, success, failure);
+	}
+
+	bool compare_exchange_strong (P& expected, const P desired, const std::memory_order, const std::memory_order) noexcept
+	{
+		const unsigned __int128 e = to_raw(expected);
+		const unsigned __int128 previous = __sync_val_compare_and_swap(&_raw, e, to_raw(desired));
+		if (previous == e)
+		{
+			return true;
+		}
+		expected = from_raw(previous);
+		return false;
+	}
+
+private:
+	typedef uint64_t __attribute__((may_alias)) Word;
+
+	unsigned __int128 peek_raw () const noexcept
+	{
+		const Word* words = reinterpret_cast<const Word*>(&_raw);
+		const uint64_t halves[2] = {__atomic_load_n(&words[0], __ATOMIC_RELAXED), __atomic_load_n(&words[1], __ATOMIC_RELAXED)};
+		unsigned __int128 raw;
+		__builtin_memcpy(&raw, halves, sizeof(raw));
+		return raw;
+	}
+
+	static unsigned __int128 to_raw (const P p) noexcept
+	{
+		unsigned __int128 raw;
+		__builtin_memcpy(&raw, &p, sizeof(raw));
+		return raw;
+	}
+
+	static P from_raw (const unsigned __int128 raw) noexcept
+	{
+		P p;
+		__builtin_memcpy(&p, &raw, sizeof(p));
+		return p;
+	}
+
+	alignas(16) mutable unsigned __int128 _raw;
+};
+#endif
+
+}
+
+template <Fraction_compatible T>
+class atomic_fraction
+{
+	static_assert(std::is_trivially_copyable_v<T>, "tokox::atomic_fraction needs a trivially copyable T");
+
+public:
+	atomic_fraction (const Fraction<T>& f = Fraction<T>());
+
+	atomic_fraction (const atomic_fraction&) = delete;
+	atomic_fraction& operator= (const atomic_fraction&) = delete;
+
+	static constexpr bool is_always_lock_free = detail::AtomicStorage<detail::PackedFraction<T>>::is_always_lock_free;
+	bool is_lock_free () const noexcept;
+
+
+	Fraction<T> load (const std::memory_order order = std::memory_order_seq_cst) const;
+	void store (const Fraction<T>& f, const std::memory_order order = std::memory_order_seq_cst);
+	Fraction<T> exchange (const Fraction<T>& f, const std::memory_order order = std::memory_order_seq_cst);
+
+	bool compare_exchange_weak (Fraction<T>& expected, const Fraction<T>& desired,
+		const std::memory_order success, const std::memory_order failure);
+	bool compare_exchange_weak (Fraction<T>& expected, const Fraction<T>& desired,
+		const std::memory_order order = std::memory_order_seq_cst);
+	bool compare_exchange_strong (Fraction<T>& expected, const Fraction<T>& desired,
+		const std::memory_order success, const std::memory_order failure);
+	bool compare_exchange_strong (Fraction<T>& expected, const Fraction<T>& desired,
+		const std::memory_order order = std::memory_order_seq_cst);
+
+
+	Fraction<T> fetch_add (const Fraction<T>& f, const std::memory_order order = std::memory_order_seq_cst);
+	Fraction<T> fetch_sub (const Fraction<T>& f, const std::memory_order order = std::memory_order_seq_cst);
+	Fraction<T> fetch_mul (const Fraction<T>& f, const std::memory_order order = std::memory_order_seq_cst);
+
+
+	operator Fraction<T> () const;
+	Fraction<T> operator= (const Fraction<T>& f);
+
+	Fraction<T> operator+= (const Fraction<T>& f);
+	Fraction<T> operator-= (const Fraction<T>& f);
+	Fraction<T> operator*= (const Fraction<T>& f);
+
+private:
+	using Packed = detail::PackedFraction<T>;
+
+	template <typename Op>
+	Fraction<T> update (Op op, const std::memory_order order);
+
+	static Packed pack (const Fraction<T>& f);
+	static Fraction<T> unpack (const Packed& p);
+	static std::memory_order failure_order (const std::memory_order order);
+
+	detail::AtomicStorage<Packed> _value;
+};
+
+template <Fraction_compatible T, std::size_t Shards = 16>
+class sharded_atomic_fraction
+{
+public:
+	sharded_atomic_fraction (const Fraction<T>& f = Fraction<T>());
+
+	void add (const Fraction<T>& f, const std::memory_order order = std::memory_order_seq_cst);
+	void sub (const Fraction<T>& f, const std::memory_order order = std::memory_order_seq_cst);
+
+	Fraction<T> load (const std::memory_order order = std::memory_order_seq_cst) const;
+	void store (const Fraction<T>& f, const std::memory_order order = std::memory_order_seq_cst);
+
+	static constexpr std::size_t shards = Shards;
+
+private:
+	static std::size_t shard_index ();
+
+	struct alignas(64) Shard
+	{
+		atomic_fraction<T> value;
+	};
+	Shard _shards[Shards];
+};
+
+}
+
+#include "atomic_fraction.cpp"
+
+#endif
@@ -0,0 +1,223 @@
+#include "bounded_fraction.hpp"
+namespace tokox
+{
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R>::BoundedFraction (const T n, const T d):
+	_value(n, d)
+{
+	bound();
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R>::BoundedFraction (const Fraction<T>& f):
+	_value(f)
+{
+	bound();
+}
+
+
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R>& BoundedFraction<T, MaxDen, R>::operator+= (const BoundedFraction& other)
+{
+	_value += other._value;
+	return bound();
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R> BoundedFraction<T, MaxDen, R>::operator+ (const BoundedFraction& other) const
+{
+	return BoundedFraction(*this) += other;
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R> BoundedFraction<T, MaxDen, R>::operator+ () const
+{
+	return BoundedFraction(*this);
+}
+
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R>& BoundedFraction<T, MaxDen, R>::operator-= (const BoundedFraction& other)
+{
+	_value -= other._value;
+	return bound();
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R> BoundedFraction<T, MaxDen, R>::operator- (const BoundedFraction& other) const
+{
+	return BoundedFraction(*this) -= other;
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R> BoundedFraction<T, MaxDen, R>::operator- () const
+{
+	BoundedFraction result(*this);
+	result._value = -_value;
+	return result;
+}
+
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R>& BoundedFraction<T, MaxDen, R>::operator*= (const BoundedFraction& other)
+{
+	_value *= other._value;
+	return bound();
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R> BoundedFraction<T, MaxDen, R>::operator* (const BoundedFraction& other) const
+{
+	return BoundedFraction(*this) *= other;
+}
+
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R>& BoundedFraction<T, MaxDen, R>::operator/= (const BoundedFraction& other)
+{
+	_value /= other._value;
+	return bound();
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R> BoundedFraction<T, MaxDen, R>::operator/ (const BoundedFraction& other) const
+{
+	return BoundedFraction(*this) /= other;
+}
+
+
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+bool BoundedFraction<T, MaxDen, R>::operator== (const BoundedFraction& other) const
+{
+	return _value.numerator() == other._value.numerator()
+		&& _value.denominator() == other._value.denominator();
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+bool BoundedFraction<T, MaxDen, R>::operator!= (const BoundedFraction& other) const
+{
+	return !((*this) == other);
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+bool BoundedFraction<T, MaxDen, R>::operator> (const BoundedFraction& other) const
+{
+	return _value > other._value;
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+bool BoundedFraction<T, MaxDen, R>::operator>= (const BoundedFraction& other) const
+{
+	return _value >= other._value;
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+bool BoundedFraction<T, MaxDen, R>::operator< (const BoundedFraction& other) const
+{
+	return _value < other._value;
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+bool BoundedFraction<T, MaxDen, R>::operator<= (const BoundedFraction& other) const
+{
+	return _value <= other._value;
+}
+
+
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R>::operator Fraction<T> () const
+{
+	return _value;
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+T BoundedFraction<T, MaxDen, R>::value () const
+{
+	return _value.value();
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+T BoundedFraction<T, MaxDen, R>::numerator () const
+{
+	return _value.numerator();
+}
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+T BoundedFraction<T, MaxDen, R>::denominator () const
+{
+	return _value.denominator();
+}
+
+// Neighbouring fractions with denominators at most MaxDen are less than
+// 1 / MaxDen apart, so rounding to nearest is off by at most half of that.
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+Fraction<T> BoundedFraction<T, MaxDen, R>::max_error ()
+{
+	if constexpr (R == Rounding::to_nearest)
+	{
+		return Fraction<T>(1, MaxDen) * Fraction<T>(1, 2);
+	}
+	else
+	{
+		return Fraction<T>(1, MaxDen);
+	}
+}
+
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+void BoundedFraction<T, MaxDen, R>::swap (BoundedFraction& other)
+{
+	_value.swap(other._value);
+}
+
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+std::size_t BoundedFraction<T, MaxDen, R>::hash () const requires Hashable<T>
+{
+	return _value.hash();
+}
+
+
+
+template <Fraction_compatible T, T MaxDen, Rounding R>
+	requires (MaxDen > T(0))
+BoundedFraction<T, MaxDen, R>& BoundedFraction<T, MaxDen, R>::bound ()
+{
+	_value.reduce();
+	if (_value.denominator() > MaxDen)
+	{
+		_value = _value.limit_denominator(MaxDen, R);
+	}
+	return *this;
+}
+
+}
@@ -0,0 +1,69 @@
+#ifndef TOKOX_FRACTIONS_BOUNDED_FRACTION
+#define TOKOX_FRACTIONS_BOUNDED_FRACTION
+
+#include <cstddef>
+#include <functional>
+
+#include "fractions.hpp"
+
+namespace tokox
+{
+
+template <Fraction_compatible T, T MaxDen, Rounding R = Rounding::to_nearest>
+	requires (MaxDen > T(0))
+class BoundedFraction
+{
+public:
+	BoundedFraction (const T n = T(0), const T d = T(1));
+	explicit BoundedFraction (const Fraction<T>& f);
+
+
+	BoundedFraction& operator+= (const BoundedFraction& other);
+	BoundedFraction operator+ (const BoundedFraction& other) const;
+	BoundedFraction operator+ () const;
+
+	BoundedFraction& operator-= (const BoundedFraction& other);
+	BoundedFraction operator- (const BoundedFraction& other) const;
+	BoundedFraction operator- () const;
+
+	BoundedFraction& operator*= (const BoundedFraction& other);
+	BoundedFraction operator* (const BoundedFraction& other) const;
+
+	BoundedFraction& operator/= (const BoundedFraction& other);
+	BoundedFraction operator/ (const BoundedFraction& other) const;
+
+
+	bool operator== (const BoundedFraction& other) const;
+	bool operator!= (const BoundedFraction& other) const;
+
+	bool operator> (const BoundedFraction& other) const;
+	bool operator>= (const BoundedFraction& other) const;
+
+	bool operator< (const BoundedFraction& other) const;
+	bool operator<= (const BoundedFraction& other) const;
+
+
+	operator Fraction<T> () const;
+
+	T value () const;
+
+	T numerator () const;
+	T denominator () const;
+
+	static Fraction<T> max_error ();
+
+
+	void swap (BoundedFraction& other);
+
+	std::size_t hash () const requires Hashable<T>;
+
+private:
+	BoundedFraction& bound ();
+	Fraction<T> _value;
+};
+
+}
+
+#include "bounded_fraction.cpp"
+
+#endif
@@ -0,0 +1,425 @@
+#include "decimal.hpp"
+namespace tokox
+{
+
+namespace detail
+{
+
+inline constexpr std::array<uint64_t, 20> powers_of_ten = []
+{
+	std::array<uint64_t, 20> p{};
+	p[0] = 1;
+	for (std::size_t i = 1; i < p.size(); ++i)
+	{
+		p[i] = p[i - 1] * 10;
+	}
+	return p;
+}();
+
+// Long division of rem / d continued for count digits, up to 19 of them per
+// 128 by 64 bit division; rem < d < 2^64 is left as the final remainder.
+inline void write_digits (uint64_t& rem, const uint64_t d, char* out, std::size_t count)
+{
+	while (count > 0)
+	{
+		if (rem == 0)
+		{
+			std::memset(out, '0', count);
+			return;
+		}
+		const std::size_t k = count < 19 ? count : 19;
+		const unsigned __int128 x = (unsigned __int128)(rem) * powers_of_ten[k];
+		uint64_t chunk = uint64_t(x / d);
+		rem = uint64_t(x % d);
+		for (std::size_t j = k; j-- > 0;)
+		{
+			out[j] = char('0' + chunk % 10);
+			chunk /= 10;
+		}
+		out += k;
+		count -= k;
+	}
+}
+
+inline uint64_t mul_mod (const uint64_t a, const uint64_t b, const uint64_t m)
+{
+	return uint64_t((unsigned __int128)(a) * b % m);
+}
+
+inline uint64_t pow_mod (uint64_t a, uint64_t e, const uint64_t m)
+{
+	uint64_t r = 1 % m;
+	a %= m;
+	for (; e > 0; e >>= 1)
+	{
+		if (e & 1)
+		{
+			r = mul_mod(r, a, m);
+		}
+		a = mul_mod(a, a, m);
+	}
+	return r;
+}
+
+// Deterministic Miller-Rabin for all n < 2^64.
+inline bool is_prime (const uint64_t n)
+{
+	if (n < 2)
+	{
+		return false;
+	}
+	constexpr uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+	for (const uint64_t p : bases)
+	{
+		if (n % p == 0)
+		{
+			return n == p;
+		}
+	}
+	const int s = std::countr_zero(n - 1);
+	const uint64_t odd = (n - 1) >> s;
+	for (const uint64_t a : bases)
+	{
+		uint64_t x = pow_mod(a, odd, n);
+		if (x == 1 || x == n - 1)
+		{
+			continue;
+		}
+		int i = 1;
+		for (; i < s; ++i)
+		{
+			x = mul_mod(x, x, n);
+			if (x == n - 1)
+			{
+				break;
+			}
+		}
+		if (i == s)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Some nontrivial factor of a composite n that has no factor below 64, by
+// Brent's variant of Pollard's rho.
+inline uint64_t find_factor (const uint64_t n)
+{
+	for (uint64_t c = 1;; ++c)
+	{
+		uint64_t y = 2, x = 2, saved = 2, g = 1, q = 1;
+		for (uint64_t r = 1; g == 1; r <<= 1)
+		{
+			x = y;
+			for (uint64_t i = 0; i < r; ++i)
+			{
+				y = (mul_mod(y, y, n) + c) % n;
+			}
+			for (uint64_t k = 0; k < r && g == 1; k += 64)
+			{
+				saved = y;
+				for (uint64_t i = 0; i < 64 && i < r - k; ++i)
+				{
+					y = (mul_mod(y, y, n) + c) % n;
+					q = mul_mod(q, x > y ? x - y : y - x, n);
+				}
+				g = std::gcd(q, n);
+			}
+		}
+		if (g == n)
+		{
+			do
+			{
+				saved = (mul_mod(saved, saved, n) + c) % n;
+				g = std::gcd(x > saved ? x - saved : saved - x, n);
+			}
+			while (g == 1);
+		}
+		if (g != n)
+		{
+			return g;
+		}
+	}
+}
+
+// The distinct prime factors of n, without allocating: n < 2^64 has at most
+// 15 of them.
+struct PrimeFactors
+{
+	std::array<uint64_t, 15> primes;
+	std::size_t count = 0;
+
+	void add (const uint64_t p)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if (primes[i] == p)
+			{
+				return;
+			}
+		}
+		primes[count++] = p;
+	}
+};
+
+inline void factor (uint64_t n, PrimeFactors& out)
+{
+	for (uint64_t p = 2; p < 64 && p * p <= n; ++p)
+	{
+		if (n % p == 0)
+		{
+			out.add(p);
+			do
+			{
+				n /= p;
+			}
+			while (n % p == 0);
+		}
+	}
+	if (n == 1)
+	{
+		return;
+	}
+	if (n < 64 * 64 || is_prime(n))
+	{
+		out.add(n);
+		return;
+	}
+	const uint64_t f = find_factor(n);
+	factor(f, out);
+	factor(n / f, out);
+}
+
+// The multiplicative order of 10 modulo m > 1 with gcd(m, 10) = 1, found by
+// dividing Carmichael's lambda(m) down rather than by stepping through the
+// remainders.
+inline uint64_t order_of_ten (const uint64_t m)
+{
+	PrimeFactors primes;
+	factor(m, primes);
+	uint64_t lambda = 1;
+	for (std::size_t i = 0; i < primes.count; ++i)
+	{
+		const uint64_t p = primes.primes[i];
+		uint64_t l = p - 1;
+		for (uint64_t rest = m / p; rest % p == 0; rest /= p)
+		{
+			l *= p;
+		}
+		lambda = lambda / std::gcd(lambda, l) * l;
+	}
+	PrimeFactors divisors;
+	factor(lambda, divisors);
+	uint64_t order = lambda;
+	for (std::size_t i = 0; i < divisors.count; ++i)
+	{
+		const uint64_t q = divisors.primes[i];
+		while (order % q == 0 && pow_mod(10, order / q, m) == 1)
+		{
+			order /= q;
+		}
+	}
+	return order;
+}
+
+template <typename T>
+uint64_t magnitude (const T v)
+{
+	return v < 0 ? uint64_t(0) - uint64_t(v) : uint64_t(v);
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool split (const Fraction<T, P>& f, uint64_t& n, uint64_t& d, const char* where)
+{
+	if (f.denominator() == T(0))
+	{
+		throw FractionDenominatorIsZeroError<T>(where);
+	}
+	n = magnitude(f.numerator());
+	d = magnitude(f.denominator());
+	return (f.numerator() < T(0)) != (f.denominator() < T(0)) && n != 0;
+}
+
+inline std::size_t write_integer (char* out, const uint64_t q)
+{
+	return std::size_t(std::to_chars(out, out + 20, q).ptr - out);
+}
+
+inline unsigned integer_length (const uint64_t q)
+{
+	unsigned length = 1;
+	while (length < 20 && q >= powers_of_ten[length])
+	{
+		++length;
+	}
+	return length;
+}
+
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t to_decimal (std::span<char> out, const Fraction<T, P>& f, const unsigned digits, const Rounding r)
+{
+	uint64_t n, d;
+	const bool negative = detail::split(f, n, d, "to_decimal");
+	uint64_t rem = n % d;
+	const std::size_t start = negative;
+	std::size_t length = start + detail::integer_length(n / d) + (digits > 0 ? 1 + std::size_t(digits) : 0);
+	if (length > out.size())
+	{
+		throw std::length_error("buffer too small in tokox::to_decimal");
+	}
+	char* const s = out.data();
+	std::size_t pos = start + detail::write_integer(s + start, n / d);
+	if (digits > 0)
+	{
+		s[pos++] = '.';
+		detail::write_digits(rem, d, s + pos, digits);
+	}
+
+	bool up;
+	switch (r)
+	{
+		case Rounding::to_nearest:
+			up = rem >= d - rem && (rem != d - rem || (s[length - 1] - '0') % 2 == 1);
+			break;
+		case Rounding::toward_zero:
+			up = false;
+			break;
+		case Rounding::toward_neg_infinity:
+			up = negative && rem != 0;
+			break;
+		case Rounding::toward_infinity:
+			up = !negative && rem != 0;
+			break;
+		default:
+			throw std::invalid_argument("unknown rounding in tokox::to_decimal");
+	}
+	for (std::size_t i = length; up && i-- > start;)
+	{
+		if (s[i] == '.')
+		{
+			continue;
+		}
+		up = s[i] == '9';
+		s[i] = up ? '0' : char(s[i] + 1);
+	}
+	if (up)
+	{
+		if (length == out.size())
+		{
+			throw std::length_error("buffer too small in tokox::to_decimal");
+		}
+		std::memmove(s + start + 1, s + start, length - start);
+		s[start] = '1';
+		++length;
+	}
+
+	if (negative)
+	{
+		bool zero = true;
+		for (std::size_t i = start; i < length && zero; ++i)
+		{
+			zero = s[i] == '0' || s[i] == '.';
+		}
+		if (zero)
+		{
+			std::memmove(s, s + 1, --length);
+		}
+		else
+		{
+			s[0] = '-';
+		}
+	}
+	return length;
+}
+
+// The expansion of n/d in lowest terms has max(a, b) digits before the period
+// for d = 2^a 5^b m with gcd(m, 10) = 1, and a period of the order of 10
+// modulo m, so its length is known before a digit is written.
+template <Fraction_compatible T, OverflowPolicy P>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t to_repeating_decimal (std::span<char> out, const Fraction<T, P>& f)
+{
+	uint64_t n, d;
+	const bool negative = detail::split(f, n, d, "to_repeating_decimal");
+	const uint64_t g = std::gcd(n, d);
+	n /= g;
+	d /= g;
+	uint64_t rem = n % d;
+
+	const unsigned twos = unsigned(std::countr_zero(d));
+	uint64_t m = d >> twos;
+	unsigned fives = 0;
+	for (; m % 5 == 0; m /= 5)
+	{
+		++fives;
+	}
+	const std::size_t pre = rem == 0 ? 0 : std::max(twos, fives);
+	const uint64_t period = m == 1 ? 0 : detail::order_of_ten(m);
+
+	const std::size_t fixed = std::size_t(negative) + detail::integer_length(n / d) + (rem == 0 ? 0 : 1 + pre) + (period == 0 ? 0 : 2);
+	if (fixed > out.size() || period > out.size() - fixed)
+	{
+		throw std::length_error("buffer too small in tokox::to_repeating_decimal");
+	}
+	char* const s = out.data();
+	std::size_t pos = 0;
+	if (negative)
+	{
+		s[pos++] = '-';
+	}
+	pos += detail::write_integer(s + pos, n / d);
+	if (rem != 0)
+	{
+		s[pos++] = '.';
+		detail::write_digits(rem, d, s + pos, pre);
+		pos += pre;
+		if (period != 0)
+		{
+			s[pos++] = '(';
+			detail::write_digits(rem, d, s + pos, period);
+			pos += period;
+			s[pos++] = ')';
+		}
+	}
+	return pos;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t to_decimal (std::span<char> out, std::span<std::size_t> ends, std::span<const Fraction<T, P>> values, const unsigned digits, const Rounding r)
+{
+	if (ends.size() < values.size())
+	{
+		throw std::invalid_argument("ends is shorter than values in tokox::to_decimal");
+	}
+	std::size_t pos = 0;
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		pos += to_decimal(out.subspan(pos), values[i], digits, r);
+		ends[i] = pos;
+	}
+	return pos;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t to_repeating_decimal (std::span<char> out, std::span<std::size_t> ends, std::span<const Fraction<T, P>> values)
+{
+	if (ends.size() < values.size())
+	{
+		throw std::invalid_argument("ends is shorter than values in tokox::to_repeating_decimal");
+	}
+	std::size_t pos = 0;
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		pos += to_repeating_decimal(out.subspan(pos), values[i]);
+		ends[i] = pos;
+	}
+	return pos;
+}
+
+}
@@ -0,0 +1,53 @@
+#ifndef TOKOX_FRACTIONS_DECIMAL
+#define TOKOX_FRACTIONS_DECIMAL
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+
+#include "fractions.hpp"
+
+namespace tokox
+{
+
+// Largest output of to_decimal with the given number of fraction digits.
+constexpr std::size_t max_decimal_size (const unsigned digits)
+{
+	return 22 + digits;
+}
+
+// Both write into out without allocating and return the number of characters
+// written; a buffer that is too small throws std::length_error. to_decimal
+// gives exactly digits fraction digits rounded as r, to_repeating_decimal the
+// exact expansion with the period in parentheses, e.g. 0.1(6) for 1/6.
+template <Fraction_compatible T, OverflowPolicy P>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t to_decimal (std::span<char> out, const Fraction<T, P>& f, const unsigned digits, const Rounding r = Rounding::to_nearest);
+
+template <Fraction_compatible T, OverflowPolicy P>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t to_repeating_decimal (std::span<char> out, const Fraction<T, P>& f);
+
+// Batch variants: the strings are written one after another and ends[i] is the
+// offset just past the i-th of them.
+template <Fraction_compatible T, OverflowPolicy P>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t to_decimal (std::span<char> out, std::span<std::size_t> ends, std::span<const Fraction<T, P>> values, const unsigned digits, const Rounding r = Rounding::to_nearest);
+
+template <Fraction_compatible T, OverflowPolicy P>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t to_repeating_decimal (std::span<char> out, std::span<std::size_t> ends, std::span<const Fraction<T, P>> values);
+
+}
+
+#include "decimal.cpp"
+
+#endif
@@ -0,0 +1,259 @@
+#include "divisor.hpp"
+namespace tokox
+{
+
+// Newton's iteration doubles the number of correct low bits, starting from the
+// 3 every odd number has as its own inverse modulo 8.
+template <std::unsigned_integral U>
+U odd_inverse (const U o)
+{
+	std::uintmax_t inverse = o;
+	for (int i = 0; i < 5; ++i)
+	{
+		inverse *= 2 - std::uintmax_t(o) * inverse;
+	}
+	return U(inverse);
+}
+
+template <std::integral T>
+	requires (std::is_signed_v<T> && sizeof(T) <= 8)
+IntegerDivisor<T>::IntegerDivisor (const T d):
+	_divisor(d),
+	_magnitude(d < T(0) ? U(U(0) - U(d)) : U(d))
+{
+	if (d == T(0))
+	{
+		throw FractionDenominatorIsZeroError<T>("IntegerDivisor::IntegerDivisor");
+	}
+	using W = std::conditional_t<sizeof(U) == 8, unsigned __int128, std::uint64_t>;
+	constexpr int bits = std::numeric_limits<U>::digits;
+	const int l = std::bit_width(U(_magnitude - U(1)));
+	_magic = U((W(1) << bits) * ((W(1) << l) - _magnitude) / _magnitude + 1);
+	_shift1 = l < 1 ? l : 1;
+	_shift2 = l < 1 ? 0 : l - 1;
+	_twos = std::countr_zero(_magnitude);
+	_inverse = odd_inverse<U>(U(_magnitude >> _twos));
+	_limit = std::numeric_limits<U>::max() / _magnitude;
+}
+
+template <std::integral T>
+	requires (std::is_signed_v<T> && sizeof(T) <= 8)
+T IntegerDivisor<T>::divisor () const
+{
+	return _divisor;
+}
+
+template <std::integral T>
+	requires (std::is_signed_v<T> && sizeof(T) <= 8)
+typename IntegerDivisor<T>::U IntegerDivisor<T>::magnitude_quotient (const U x) const
+{
+	using W = std::conditional_t<sizeof(U) == 8, unsigned __int128, std::uint64_t>;
+	const U t = U((W(_magic) * x) >> std::numeric_limits<U>::digits);
+	return U(U(t + U(U(x - t) >> _shift1)) >> _shift2);
+}
+
+// Truncates toward zero like the builtin operator.
+template <std::integral T>
+	requires (std::is_signed_v<T> && sizeof(T) <= 8)
+T IntegerDivisor<T>::quotient (const T x) const
+{
+	const U q = magnitude_quotient(x < T(0) ? U(U(0) - U(x)) : U(x));
+	return (x < T(0)) != (_divisor < T(0)) ? T(U(U(0) - q)) : T(q);
+}
+
+template <std::integral T>
+	requires (std::is_signed_v<T> && sizeof(T) <= 8)
+T IntegerDivisor<T>::remainder (const T x) const
+{
+	const U magnitude = x < T(0) ? U(U(0) - U(x)) : U(x);
+	const U r = U(magnitude - U(std::uintmax_t(magnitude_quotient(magnitude)) * _magnitude));
+	return x < T(0) ? T(U(U(0) - r)) : T(r);
+}
+
+template <std::integral T>
+	requires (std::is_signed_v<T> && sizeof(T) <= 8)
+bool IntegerDivisor<T>::divides (const T x) const
+{
+	const U magnitude = x < T(0) ? U(U(0) - U(x)) : U(x);
+	return std::rotr(U(std::uintmax_t(magnitude) * _inverse), _twos) <= _limit;
+}
+
+template <std::integral T>
+	requires (std::is_signed_v<T> && sizeof(T) <= 8)
+void IntegerDivisor<T>::quotient (std::span<const T> in, std::span<T> out) const
+{
+	if (in.size() != out.size())
+	{
+		throw std::invalid_argument("span sizes differ in tokox::IntegerDivisor::quotient");
+	}
+	for (std::size_t i = 0; i < in.size(); ++i)
+	{
+		out[i] = quotient(in[i]);
+	}
+}
+
+template <std::integral T>
+	requires (std::is_signed_v<T> && sizeof(T) <= 8)
+void IntegerDivisor<T>::is_divisible (std::span<const T> in, std::span<bool> out) const
+{
+	if (in.size() != out.size())
+	{
+		throw std::invalid_argument("span sizes differ in tokox::IntegerDivisor::is_divisible");
+	}
+	for (std::size_t i = 0; i < in.size(); ++i)
+	{
+		out[i] = divides(in[i]);
+	}
+}
+
+
+
+template <Fraction_compatible T>
+FractionDivisor<T>::FractionDivisor (const Fraction<T>& f):
+	_numerator(f.reduce().numerator()),
+	_denominator(f.denominator()),
+	_numerator_divisor(_numerator),
+	_denominator_divisor(_denominator)
+{}
+
+template <Fraction_compatible T>
+Fraction<T> FractionDivisor<T>::divisor () const
+{
+	return Fraction<T>::from_reduced(_numerator, _denominator);
+}
+
+// An unreduced x is divided as it is and gives an unreduced quotient; it is
+// reduced, with a full gcd, only when that quotient would overflow.
+template <Fraction_compatible T>
+Fraction<T> FractionDivisor<T>::divide (const Fraction<T>& x) const
+{
+	T a = x.numerator();
+	T b = x.denominator();
+	T p = _numerator;
+	T q = _denominator;
+	const T g1 = gcd<T>(_numerator, _numerator_divisor.remainder(a));
+	if (g1 != T(1))
+	{
+		a /= g1;
+		p /= g1;
+	}
+	const T g2 = gcd<T>(_denominator, _denominator_divisor.remainder(b));
+	if (g2 != T(1))
+	{
+		b /= g2;
+		q /= g2;
+	}
+	if (!can_mul<T>(a, q) || !can_mul<T>(b, p))
+	{
+		if (!x.reduced())
+		{
+			return divide(x.reduce());
+		}
+		throw FractionOverflowError<T>("FractionDivisor::divide");
+	}
+	T n = a * q;
+	T d = b * p;
+	if (d < T(0))
+	{
+		if (!can_neg<T>(n) || !can_neg<T>(d))
+		{
+			if (!x.reduced())
+			{
+				return divide(x.reduce());
+			}
+			throw FractionOverflowError<T>("FractionDivisor::divide");
+		}
+		n = -n;
+		d = -d;
+	}
+	return x.reduced() ? Fraction<T>::from_reduced(n, d) : Fraction<T>(n, d);
+}
+
+// x / f is an integer exactly when p divides a and b divides q, for x = a/b in
+// lowest terms; that is why an unreduced x is reduced first (a no-op for one
+// already flagged). b divides q when gcd(q, b mod q) is b, and b mod q comes
+// from the precomputed divisor, so the only division left is inside that gcd,
+// which is skipped for b = 1 and b > q.
+template <Fraction_compatible T>
+bool FractionDivisor<T>::is_divisible (const Fraction<T>& x) const
+{
+	x.reduce();
+	const T b = x.denominator();
+	if (!_numerator_divisor.divides(x.numerator()) || b > _denominator)
+	{
+		return false;
+	}
+	return b == T(1) || gcd<T>(_denominator, _denominator_divisor.remainder(b)) == b;
+}
+
+template <Fraction_compatible T>
+void FractionDivisor<T>::divide (std::span<const Fraction<T>> in, std::span<Fraction<T>> out) const
+{
+	if (in.size() != out.size())
+	{
+		throw std::invalid_argument("span sizes differ in tokox::FractionDivisor::divide");
+	}
+	for (std::size_t i = 0; i < in.size(); ++i)
+	{
+		out[i] = divide(in[i]);
+	}
+}
+
+template <Fraction_compatible T>
+void FractionDivisor<T>::is_divisible (std::span<const Fraction<T>> in, std::span<bool> out) const
+{
+	if (in.size() != out.size())
+	{
+		throw std::invalid_argument("span sizes differ in tokox::FractionDivisor::is_divisible");
+	}
+	for (std::size_t i = 0; i < in.size(); ++i)
+	{
+		out[i] = is_divisible(in[i]);
+	}
+}
+
+
+
+// If d divides the denominator, (denominator >> s) times the inverse of the
+// odd part of d is the quotient; the multiplication back rejects every d that
+// does not.
+template <std::integral T>
+	requires (std::is_signed_v<T> && sizeof(T) <= 8)
+void rescale_to_common (std::span<const Fraction<T>> in, const T denominator, std::span<T> numerators)
+{
+	using U = std::make_unsigned_t<T>;
+	if (in.size() != numerators.size())
+	{
+		throw std::invalid_argument("span sizes differ in tokox::rescale_to_common");
+	}
+	if (denominator <= T(0))
+	{
+		throw std::invalid_argument("denominator <= 0 in tokox::rescale_to_common");
+	}
+	const auto factor = [denominator] (const T d, U& k)
+	{
+		const int s = std::countr_zero(U(d));
+		k = U(std::uintmax_t(U(denominator) >> s) * odd_inverse<U>(U(U(d) >> s)));
+		U product;
+		return !__builtin_mul_overflow(k, U(d), &product) && product == U(denominator);
+	};
+	for (std::size_t i = 0; i < in.size(); ++i)
+	{
+		U k;
+		if (!factor(in[i].denominator(), k))
+		{
+			in[i].reduce();
+			if (!factor(in[i].denominator(), k))
+			{
+				throw FractionInexactError<T>("rescale_to_common");
+			}
+		}
+		if (!can_mul<T>(in[i].numerator(), T(k)))
+		{
+			throw FractionOverflowError<T>("rescale_to_common");
+		}
+		numerators[i] = in[i].numerator() * T(k);
+	}
+}
+
+}
@@ -0,0 +1,90 @@
+#ifndef TOKOX_FRACTIONS_DIVISOR
+#define TOKOX_FRACTIONS_DIVISOR
+
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <concepts>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "fractions.hpp"
+
+namespace tokox
+{
+
+// Division by an integer fixed at construction: quotients use the
+// Granlund-Montgomery multiply and shift, divisibility tests the inverse of
+// the odd part of the divisor modulo 2^N. Neither executes a division
+// instruction, so the span kernels vectorize.
+template <std::integral T>
+	requires (std::is_signed_v<T> && sizeof(T) <= 8)
+class IntegerDivisor
+{
+public:
+	explicit IntegerDivisor (const T d);
+
+	T divisor () const;
+
+	T quotient (const T x) const;
+	T remainder (const T x) const;
+	bool divides (const T x) const;
+
+	void quotient (std::span<const T> in, std::span<T> out) const;
+	void is_divisible (std::span<const T> in, std::span<bool> out) const;
+
+private:
+	using U = std::make_unsigned_t<T>;
+	U magnitude_quotient (const U x) const;
+
+	T _divisor;
+	U _magnitude;
+	U _magic;
+	uint8_t _shift1;
+	uint8_t _shift2;
+	U _inverse;
+	U _limit;
+	uint8_t _twos;
+};
+
+// x / f for many x and one fixed f = p/q. For a reduced x = a/b the quotient
+// (a/g1 * q/g2) / (b/g2 * p/g1) with g1 = gcd(a, p) and g2 = gcd(b, q) is
+// reduced already; a mod p and b mod q come from the precomputed divisors and
+// the divisions by g1 and g2 are skipped when they are 1.
+template <Fraction_compatible T>
+class FractionDivisor
+{
+	static_assert(std::integral<T> && sizeof(T) <= 8, "tokox::FractionDivisor needs a builtin integer type");
+
+public:
+	explicit FractionDivisor (const Fraction<T>& f);
+
+	Fraction<T> divisor () const;
+
+	Fraction<T> divide (const Fraction<T>& x) const;
+	bool is_divisible (const Fraction<T>& x) const;
+
+	void divide (std::span<const Fraction<T>> in, std::span<Fraction<T>> out) const;
+	void is_divisible (std::span<const Fraction<T>> in, std::span<bool> out) const;
+
+private:
+	T _numerator;
+	T _denominator;
+	IntegerDivisor<T> _numerator_divisor;
+	IntegerDivisor<T> _denominator_divisor;
+};
+
+// Numerators of the fractions over one common denominator. The factor
+// denominator / d is an exact division, done with the inverse of the odd part
+// of d instead of a division instruction.
+template <std::integral T>
+	requires (std::is_signed_v<T> && sizeof(T) <= 8)
+void rescale_to_common (std::span<const Fraction<T>> in, const T denominator, std::span<T> numerators);
+
+}
+
+#include "divisor.cpp"
+
+#endif
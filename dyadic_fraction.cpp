@@ -0,0 +1,331 @@
+#include "dyadic_fraction.hpp"
+namespace tokox
+{
+
+template <Fraction_compatible T>
+DyadicFraction<T>::DyadicFraction (const T n, const int e):
+	_numerator(n),
+	_exponent(e)
+{
+	if (_exponent < 0)
+	{
+		if (!shift_left(_numerator, -_exponent))
+		{
+			throw FractionOverflowError<T>("DyadicFraction::DyadicFraction");
+		}
+		_exponent = 0;
+	}
+	normalize("DyadicFraction::DyadicFraction");
+}
+
+template <Fraction_compatible T>
+DyadicFraction<T>::DyadicFraction (const Fraction<T>& f):
+	_numerator(T(0)),
+	_exponent(0)
+{
+	f.reduce();
+	const int e = ctz<T>(f.denominator());
+	if (shift_right(f.denominator(), e) != T(1))
+	{
+		throw FractionInexactError<T>("DyadicFraction::DyadicFraction");
+	}
+	_numerator = f.numerator();
+	_exponent = e;
+}
+
+
+
+template <Fraction_compatible T>
+DyadicFraction<T>& DyadicFraction<T>::operator+= (const DyadicFraction& other)
+{
+	T other_numerator = other._numerator;
+	if (_exponent < other._exponent)
+	{
+		if (!shift_left(_numerator, other._exponent - _exponent))
+		{
+			throw FractionOverflowError<T>("DyadicFraction::operator+=");
+		}
+		_exponent = other._exponent;
+	}
+	else if (!shift_left(other_numerator, _exponent - other._exponent))
+	{
+		throw FractionOverflowError<T>("DyadicFraction::operator+=");
+	}
+	if (!can_add<T>(_numerator, other_numerator))
+	{
+		throw FractionOverflowError<T>("DyadicFraction::operator+=");
+	}
+	_numerator += other_numerator;
+	normalize("DyadicFraction::operator+=");
+	return *this;
+}
+
+template <Fraction_compatible T>
+DyadicFraction<T> DyadicFraction<T>::operator+ (const DyadicFraction& other) const
+{
+	return DyadicFraction(*this) += other;
+}
+
+template <Fraction_compatible T>
+DyadicFraction<T> DyadicFraction<T>::operator+ () const
+{
+	return DyadicFraction(*this);
+}
+
+
+template <Fraction_compatible T>
+DyadicFraction<T>& DyadicFraction<T>::operator-= (const DyadicFraction& other)
+{
+	T other_numerator = other._numerator;
+	if (_exponent < other._exponent)
+	{
+		if (!shift_left(_numerator, other._exponent - _exponent))
+		{
+			throw FractionOverflowError<T>("DyadicFraction::operator-=");
+		}
+		_exponent = other._exponent;
+	}
+	else if (!shift_left(other_numerator, _exponent - other._exponent))
+	{
+		throw FractionOverflowError<T>("DyadicFraction::operator-=");
+	}
+	if (!can_sub<T>(_numerator, other_numerator))
+	{
+		throw FractionOverflowError<T>("DyadicFraction::operator-=");
+	}
+	_numerator -= other_numerator;
+	normalize("DyadicFraction::operator-=");
+	return *this;
+}
+
+template <Fraction_compatible T>
+DyadicFraction<T> DyadicFraction<T>::operator- (const DyadicFraction& other) const
+{
+	return DyadicFraction(*this) -= other;
+}
+
+template <Fraction_compatible T>
+DyadicFraction<T> DyadicFraction<T>::operator- () const
+{
+	if (!can_neg<T>(_numerator))
+	{
+		throw FractionOverflowError<T>("DyadicFraction::operator-");
+	}
+	DyadicFraction result(*this);
+	result._numerator = -_numerator;
+	return result;
+}
+
+
+template <Fraction_compatible T>
+DyadicFraction<T>& DyadicFraction<T>::operator*= (const DyadicFraction& other)
+{
+	if (!can_mul<T>(_numerator, other._numerator))
+	{
+		throw FractionOverflowError<T>("DyadicFraction::operator*=");
+	}
+	_numerator *= other._numerator;
+	_exponent += other._exponent;
+	normalize("DyadicFraction::operator*=");
+	return *this;
+}
+
+template <Fraction_compatible T>
+DyadicFraction<T> DyadicFraction<T>::operator* (const DyadicFraction& other) const
+{
+	return DyadicFraction(*this) *= other;
+}
+
+
+
+template <Fraction_compatible T>
+bool DyadicFraction<T>::operator== (const DyadicFraction& other) const
+{
+	return _numerator == other._numerator && _exponent == other._exponent;
+}
+
+template <Fraction_compatible T>
+bool DyadicFraction<T>::operator!= (const DyadicFraction& other) const
+{
+	return !((*this) == other);
+}
+
+// When aligning the exponents overflows, the shifted numerator is larger in
+// magnitude than any T, so its sign alone decides the comparison.
+template <Fraction_compatible T>
+bool DyadicFraction<T>::operator< (const DyadicFraction& other) const
+{
+	if (_exponent == other._exponent)
+	{
+		return _numerator < other._numerator;
+	}
+	if (_exponent < other._exponent)
+	{
+		T n = _numerator;
+		if (!shift_left(n, other._exponent - _exponent))
+		{
+			return _numerator < T(0);
+		}
+		return n < other._numerator;
+	}
+	T n = other._numerator;
+	if (!shift_left(n, _exponent - other._exponent))
+	{
+		return n > T(0);
+	}
+	return _numerator < n;
+}
+
+template <Fraction_compatible T>
+bool DyadicFraction<T>::operator> (const DyadicFraction& other) const
+{
+	return other < (*this);
+}
+
+template <Fraction_compatible T>
+bool DyadicFraction<T>::operator<= (const DyadicFraction& other) const
+{
+	return !((*this) > other);
+}
+
+template <Fraction_compatible T>
+bool DyadicFraction<T>::operator>= (const DyadicFraction& other) const
+{
+	return !((*this) < other);
+}
+
+
+
+template <Fraction_compatible T>
+DyadicFraction<T>::operator Fraction<T> () const
+{
+	return Fraction<T>(_numerator, power_of_two(_exponent)).reduce();
+}
+
+template <Fraction_compatible T>
+T DyadicFraction<T>::value () const
+{
+	return _numerator / power_of_two(_exponent);
+}
+
+template <Fraction_compatible T>
+T DyadicFraction<T>::numerator () const
+{
+	return _numerator;
+}
+
+template <Fraction_compatible T>
+int DyadicFraction<T>::exponent () const
+{
+	return _exponent;
+}
+
+template <Fraction_compatible T>
+T DyadicFraction<T>::denominator () const
+{
+	return power_of_two(_exponent);
+}
+
+
+template <Fraction_compatible T>
+void DyadicFraction<T>::swap (DyadicFraction& other)
+{
+	const DyadicFraction other_copy(other);
+	other = *this;
+	*this = other_copy;
+}
+
+
+template <Fraction_compatible T>
+std::size_t DyadicFraction<T>::hash () const requires Hashable<T>
+{
+	return Fraction<T>(*this).hash();
+}
+
+
+
+template <Fraction_compatible T>
+void DyadicFraction<T>::normalize (const char* where)
+{
+	if (_numerator == T(0))
+	{
+		_exponent = 0;
+		return;
+	}
+	int s = ctz<T>(_numerator);
+	if (s > _exponent)
+	{
+		s = _exponent;
+	}
+	_numerator = shift_right(_numerator, s);
+	_exponent -= s;
+	if (_exponent > max_exponent)
+	{
+		throw FractionOverflowError<T>(where);
+	}
+}
+
+template <Fraction_compatible T>
+bool DyadicFraction<T>::shift_left (T& n, int s)
+{
+	if (s == 0 || n == T(0))
+	{
+		return true;
+	}
+	if constexpr (std::integral<T>)
+	{
+		if (s >= std::numeric_limits<T>::digits)
+		{
+			return false;
+		}
+		if (n > (std::numeric_limits<T>::max() >> s) || n < (std::numeric_limits<T>::lowest() >> s))
+		{
+			return false;
+		}
+		n = n * (T(1) << s);
+		return true;
+	}
+	else
+	{
+		for (; s > 0; --s)
+		{
+			if (!can_mul<T>(n, T(2)))
+			{
+				return false;
+			}
+			n = n * T(2);
+		}
+		return true;
+	}
+}
+
+template <Fraction_compatible T>
+T DyadicFraction<T>::shift_right (const T& n, int s)
+{
+	if constexpr (std::integral<T>)
+	{
+		return n >> s;
+	}
+	else
+	{
+		T r = n;
+		for (; s > 0; --s)
+		{
+			r = r / T(2);
+		}
+		return r;
+	}
+}
+
+template <Fraction_compatible T>
+T DyadicFraction<T>::power_of_two (int e)
+{
+	T r = T(1);
+	if (shift_left(r, e))
+	{
+		return r;
+	}
+	throw FractionOverflowError<T>("DyadicFraction::power_of_two");
+}
+
+}
@@ -0,0 +1,71 @@
+#ifndef TOKOX_FRACTIONS_DYADIC_FRACTION
+#define TOKOX_FRACTIONS_DYADIC_FRACTION
+
+#include <cstddef>
+#include <limits>
+#include <functional>
+
+#include "fractions.hpp"
+
+namespace tokox
+{
+
+template <Fraction_compatible T = int>
+class DyadicFraction
+{
+public:
+	DyadicFraction (const T n = T(0), const int e = 0);
+	explicit DyadicFraction (const Fraction<T>& f);
+
+
+	DyadicFraction& operator+= (const DyadicFraction& other);
+	DyadicFraction operator+ (const DyadicFraction& other) const;
+	DyadicFraction operator+ () const;
+
+	DyadicFraction& operator-= (const DyadicFraction& other);
+	DyadicFraction operator- (const DyadicFraction& other) const;
+	DyadicFraction operator- () const;
+
+	DyadicFraction& operator*= (const DyadicFraction& other);
+	DyadicFraction operator* (const DyadicFraction& other) const;
+
+
+	bool operator== (const DyadicFraction& other) const;
+	bool operator!= (const DyadicFraction& other) const;
+
+	bool operator> (const DyadicFraction& other) const;
+	bool operator>= (const DyadicFraction& other) const;
+
+	bool operator< (const DyadicFraction& other) const;
+	bool operator<= (const DyadicFraction& other) const;
+
+
+	operator Fraction<T> () const;
+
+	T value () const;
+
+	T numerator () const;
+	int exponent () const;
+	T denominator () const;
+
+
+	void swap (DyadicFraction& other);
+
+	std::size_t hash () const requires Hashable<T>;
+
+	static constexpr int max_exponent = std::numeric_limits<T>::is_bounded ? std::numeric_limits<T>::digits - 1 : std::numeric_limits<int>::max();
+
+private:
+	void normalize (const char* where);
+	static bool shift_left (T& n, int s);
+	static T shift_right (const T& n, int s);
+	static T power_of_two (int e);
+	T _numerator;
+	int _exponent;
+};
+
+}
+
+#include "dyadic_fraction.cpp"
+
+#endif
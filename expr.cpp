@@ -0,0 +1,685 @@
+#include "expr.hpp"
+namespace tokox::expr
+{
+
+namespace detail
+{
+
+enum class OperandKind : uint8_t
+{
+	variable,
+	constant,
+	temporary
+};
+
+struct Operand
+{
+	OperandKind kind;
+	uint16_t index;
+};
+
+struct PendingInstruction
+{
+	Opcode op;
+	Operand dst;
+	Operand a;
+	Operand b;
+};
+
+template <Fraction_compatible T>
+struct Value
+{
+	bool is_constant;
+	Fraction<T> constant;
+	Operand operand;
+};
+
+// Recursive descent parser that folds constant subexpressions while parsing
+// and emits register code for everything that depends on a variable.
+// Temporaries are recycled as soon as their value has been consumed.
+template <Fraction_compatible T>
+class Compiler
+{
+public:
+	explicit Compiler (const std::string& source):
+		_source(source),
+		_position(0),
+		_temporaries(0)
+	{}
+
+	void compile (std::vector<std::string>& variables,
+		std::vector<Fraction<T>>& constants,
+		std::vector<Instruction>& instructions,
+		std::size_t& registers,
+		uint16_t& result)
+	{
+		Value<T> value = expression();
+		skip_spaces();
+		if (_position != _source.size())
+		{
+			throw ExpressionError("unexpected '" + std::string(1, _source[_position]) + "'", _position);
+		}
+		const Operand r = materialize(value);
+		const std::size_t base_constants = _variables.size();
+		const std::size_t base_temporaries = base_constants + _constants.size();
+		registers = base_temporaries + _temporaries;
+		if (registers > UINT16_MAX)
+		{
+			throw ExpressionError("expression too large", 0);
+		}
+		auto flat = [&] (const Operand& o) -> uint16_t
+		{
+			switch (o.kind)
+			{
+				case OperandKind::variable:
+					return o.index;
+				case OperandKind::constant:
+					return base_constants + o.index;
+				default:
+					return base_temporaries + o.index;
+			}
+		};
+		instructions.clear();
+		instructions.reserve(_code.size());
+		for (const PendingInstruction& p : _code)
+		{
+			instructions.push_back(Instruction{p.op, flat(p.dst), flat(p.a), flat(p.b)});
+		}
+		result = flat(r);
+		variables = std::move(_variables);
+		constants = std::move(_constants);
+	}
+
+private:
+	Value<T> expression ()
+	{
+		Value<T> left = term();
+		while (true)
+		{
+			skip_spaces();
+			const std::size_t position = _position;
+			if (accept('+'))
+			{
+				left = binary(Opcode::add, left, term(), position);
+			}
+			else if (accept('-'))
+			{
+				left = binary(Opcode::sub, left, term(), position);
+			}
+			else
+			{
+				return left;
+			}
+		}
+	}
+
+	Value<T> term ()
+	{
+		Value<T> left = unary();
+		while (true)
+		{
+			skip_spaces();
+			const std::size_t position = _position;
+			if (accept('*'))
+			{
+				left = binary(Opcode::mul, left, unary(), position);
+			}
+			else if (accept('/'))
+			{
+				left = binary(Opcode::div, left, unary(), position);
+			}
+			else if (accept('%'))
+			{
+				left = binary(Opcode::mod, left, unary(), position);
+			}
+			else
+			{
+				return left;
+			}
+		}
+	}
+
+	Value<T> unary ()
+	{
+		skip_spaces();
+		const std::size_t position = _position;
+		if (accept('-'))
+		{
+			return negate(unary(), position);
+		}
+		if (accept('+'))
+		{
+			return unary();
+		}
+		return primary();
+	}
+
+	Value<T> primary ()
+	{
+		skip_spaces();
+		if (_position == _source.size())
+		{
+			throw ExpressionError("unexpected end of expression", _position);
+		}
+		const char c = _source[_position];
+		if (accept('('))
+		{
+			Value<T> inner = expression();
+			skip_spaces();
+			if (!accept(')'))
+			{
+				throw ExpressionError("expected ')'", _position);
+			}
+			return inner;
+		}
+		if (is_digit(c) || c == '.')
+		{
+			return number();
+		}
+		if (is_identifier_start(c))
+		{
+			return variable();
+		}
+		throw ExpressionError("unexpected '" + std::string(1, c) + "'", _position);
+	}
+
+	Value<T> number ()
+	{
+		const std::size_t start = _position;
+		T n = T(0);
+		T d = T(1);
+		bool digits = false;
+		bool fraction = false;
+		while (_position < _source.size() && (is_digit(_source[_position]) || (!fraction && _source[_position] == '.')))
+		{
+			if (_source[_position] == '.')
+			{
+				fraction = true;
+				++_position;
+				continue;
+			}
+			const T digit = T(_source[_position] - '0');
+			if (!can_mul<T>(n, T(10)) || !can_add<T>(n * T(10), digit) || (fraction && !can_mul<T>(d, T(10))))
+			{
+				throw ExpressionError("literal out of range", start);
+			}
+			n = n * T(10) + digit;
+			if (fraction)
+			{
+				d = d * T(10);
+			}
+			digits = true;
+			++_position;
+		}
+		if (!digits)
+		{
+			throw ExpressionError("malformed number", start);
+		}
+		return Value<T>{true, Fraction<T>(n, d).reduce(), {}};
+	}
+
+	Value<T> variable ()
+	{
+		const std::size_t start = _position;
+		while (_position < _source.size() && (is_identifier_start(_source[_position]) || is_digit(_source[_position])))
+		{
+			++_position;
+		}
+		const std::string name = _source.substr(start, _position - start);
+		for (std::size_t i = 0; i < _variables.size(); ++i)
+		{
+			if (_variables[i] == name)
+			{
+				return Value<T>{false, Fraction<T>(), Operand{OperandKind::variable, uint16_t(i)}};
+			}
+		}
+		if (_variables.size() >= UINT16_MAX)
+		{
+			throw ExpressionError("too many variables", start);
+		}
+		_variables.push_back(name);
+		return Value<T>{false, Fraction<T>(), Operand{OperandKind::variable, uint16_t(_variables.size() - 1)}};
+	}
+
+	Value<T> binary (const Opcode op, const Value<T>& a, const Value<T>& b, const std::size_t position)
+	{
+		if (a.is_constant && b.is_constant)
+		{
+			return Value<T>{true, fold(op, a.constant, b.constant, position), {}};
+		}
+		const Operand left = materialize(a);
+		const Operand right = materialize(b);
+		Operand dst;
+		if (left.kind == OperandKind::temporary)
+		{
+			dst = left;
+			release(right);
+		}
+		else if (right.kind == OperandKind::temporary)
+		{
+			dst = right;
+		}
+		else
+		{
+			dst = Operand{OperandKind::temporary, allocate_temporary()};
+		}
+		_code.push_back(PendingInstruction{op, dst, left, right});
+		return Value<T>{false, Fraction<T>(), dst};
+	}
+
+	Value<T> negate (const Value<T>& a, const std::size_t position)
+	{
+		if (a.is_constant)
+		{
+			try
+			{
+				return Value<T>{true, -a.constant, {}};
+			}
+			catch (std::overflow_error&)
+			{
+				throw ExpressionError("overflow in constant subexpression", position);
+			}
+		}
+		const Operand dst = a.operand.kind == OperandKind::temporary ? a.operand : Operand{OperandKind::temporary, allocate_temporary()};
+		_code.push_back(PendingInstruction{Opcode::neg, dst, a.operand, a.operand});
+		return Value<T>{false, Fraction<T>(), dst};
+	}
+
+	Fraction<T> fold (const Opcode op, const Fraction<T>& a, const Fraction<T>& b, const std::size_t position)
+	{
+		if ((op == Opcode::div || op == Opcode::mod) && b.numerator() == T(0))
+		{
+			throw ExpressionError("division by zero in constant subexpression", position);
+		}
+		try
+		{
+			switch (op)
+			{
+				case Opcode::add:
+					return (a + b).reduce();
+				case Opcode::sub:
+					return (a - b).reduce();
+				case Opcode::mul:
+					return (a * b).reduce();
+				case Opcode::div:
+					return (a / b).reduce();
+				default:
+					return (a % b).reduce();
+			}
+		}
+		catch (std::overflow_error&)
+		{
+			throw ExpressionError("overflow in constant subexpression", position);
+		}
+	}
+
+	Operand materialize (const Value<T>& v)
+	{
+		if (!v.is_constant)
+		{
+			return v.operand;
+		}
+		for (std::size_t i = 0; i < _constants.size(); ++i)
+		{
+			if (_constants[i].numerator() == v.constant.numerator() && _constants[i].denominator() == v.constant.denominator())
+			{
+				return Operand{OperandKind::constant, uint16_t(i)};
+			}
+		}
+		if (_constants.size() >= UINT16_MAX)
+		{
+			throw ExpressionError("too many constants", _position);
+		}
+		_constants.push_back(v.constant);
+		return Operand{OperandKind::constant, uint16_t(_constants.size() - 1)};
+	}
+
+	uint16_t allocate_temporary ()
+	{
+		if (!_free.empty())
+		{
+			const uint16_t t = _free.back();
+			_free.pop_back();
+			return t;
+		}
+		if (_temporaries >= UINT16_MAX)
+		{
+			throw ExpressionError("expression too large", _position);
+		}
+		return _temporaries++;
+	}
+
+	void release (const Operand& o)
+	{
+		if (o.kind == OperandKind::temporary)
+		{
+			_free.push_back(o.index);
+		}
+	}
+
+	bool accept (const char c)
+	{
+		if (_position < _source.size() && _source[_position] == c)
+		{
+			++_position;
+			return true;
+		}
+		return false;
+	}
+
+	void skip_spaces ()
+	{
+		while (_position < _source.size() && (_source[_position] == ' ' || _source[_position] == '\t'))
+		{
+			++_position;
+		}
+	}
+
+	static bool is_digit (const char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	static bool is_identifier_start (const char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+	}
+
+	const std::string& _source;
+	std::size_t _position;
+	std::vector<std::string> _variables;
+	std::vector<Fraction<T>> _constants;
+	std::vector<PendingInstruction> _code;
+	std::vector<uint16_t> _free;
+	uint16_t _temporaries;
+};
+
+}
+
+
+
+template <Fraction_compatible T>
+Program<T>::Program (const std::string& source):
+	_variables(),
+	_constants(),
+	_instructions(),
+	_registers(0),
+	_result(0)
+{
+	detail::Compiler<T>(source).compile(_variables, _constants, _instructions, _registers, _result);
+}
+
+
+
+template <Fraction_compatible T>
+Status Program<T>::evaluate (std::span<const Fraction<T>> inputs, Fraction<T>& result) const
+{
+	if (inputs.size() != _variables.size())
+	{
+		throw std::invalid_argument("wrong number of inputs in tokox::expr::Program::evaluate");
+	}
+	std::vector<Fraction<T>> regs = make_registers();
+	std::copy(inputs.begin(), inputs.end(), regs.begin());
+	const Status status = run(regs);
+	if (status == Status::ok)
+	{
+		result = regs[_result];
+	}
+	return status;
+}
+
+// Rows are handed out in chunks through an atomic cursor; every worker owns
+// a register file with the constants loaded once.
+template <Fraction_compatible T>
+void Program<T>::evaluate (std::span<const std::span<const Fraction<T>>> columns,
+	std::span<Fraction<T>> results,
+	std::span<Status> statuses,
+	const unsigned threads) const
+{
+	if (columns.size() != _variables.size() || statuses.size() != results.size())
+	{
+		throw std::invalid_argument("wrong number of columns in tokox::expr::Program::evaluate");
+	}
+	const std::size_t rows = results.size();
+	for (const auto& column : columns)
+	{
+		if (column.size() < rows)
+		{
+			throw std::invalid_argument("column too short in tokox::expr::Program::evaluate");
+		}
+	}
+	std::atomic<std::size_t> next(0);
+	auto work = [&] ()
+	{
+		std::vector<Fraction<T>> regs = make_registers();
+		while (true)
+		{
+			const std::size_t begin = next.fetch_add(chunk_size, std::memory_order_relaxed);
+			if (begin >= rows)
+			{
+				return;
+			}
+			const std::size_t end = std::min(begin + chunk_size, rows);
+			for (std::size_t row = begin; row < end; ++row)
+			{
+				for (std::size_t v = 0; v < columns.size(); ++v)
+				{
+					regs[v] = columns[v][row];
+				}
+				statuses[row] = run(regs);
+				results[row] = statuses[row] == Status::ok ? regs[_result] : Fraction<T>();
+			}
+		}
+	};
+	if (threads <= 1 || rows <= chunk_size)
+	{
+		work();
+		return;
+	}
+	std::exception_ptr error;
+	std::mutex error_mutex;
+	auto guarded = [&] ()
+	{
+		try
+		{
+			work();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(error_mutex);
+			if (!error)
+			{
+				error = std::current_exception();
+			}
+		}
+	};
+	std::vector<std::thread> workers;
+	for (unsigned w = 1; w < threads; ++w)
+	{
+		workers.emplace_back(guarded);
+	}
+	guarded();
+	for (std::thread& t : workers)
+	{
+		t.join();
+	}
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+
+
+template <Fraction_compatible T>
+const std::vector<std::string>& Program<T>::variables () const
+{
+	return _variables;
+}
+
+template <Fraction_compatible T>
+const std::vector<Instruction>& Program<T>::instructions () const
+{
+	return _instructions;
+}
+
+template <Fraction_compatible T>
+const std::vector<Fraction<T>>& Program<T>::constants () const
+{
+	return _constants;
+}
+
+template <Fraction_compatible T>
+std::size_t Program<T>::registers () const
+{
+	return _registers;
+}
+
+
+
+// r = r op b, with b nonzero for div and mod. The plain cross products are
+// tried first, as in the operators; only when one does not fit are both
+// operands reduced for the cross-cancelling forms. Returns false instead of
+// throwing when the result does not fit in W.
+template <Fraction_compatible T>
+template <Fraction_compatible W>
+bool Program<T>::apply (const Opcode op, Fraction<W>& r, const Fraction<W>& b)
+{
+	using F = Fraction<W>;
+	switch (op)
+	{
+		case Opcode::add:
+		case Opcode::sub:
+		{
+			const bool subtract = op == Opcode::sub;
+			if (can_mul<W>(r.numerator(), b.denominator()) && can_mul<W>(b.numerator(), r.denominator())
+				&& can_mul<W>(r.denominator(), b.denominator()))
+			{
+				const W left = r.numerator() * b.denominator();
+				const W right = b.numerator() * r.denominator();
+				if (subtract ? can_sub<W>(left, right) : can_add<W>(left, right))
+				{
+					r = F(subtract ? left - right : left + right, r.denominator() * b.denominator());
+					return true;
+				}
+			}
+			r.reduce();
+			return r.try_henrici(b.reduce(), subtract);
+		}
+		case Opcode::mul:
+			if (can_mul<W>(r.numerator(), b.numerator()) && can_mul<W>(r.denominator(), b.denominator()))
+			{
+				r = F(r.numerator() * b.numerator(), r.denominator() * b.denominator());
+				return true;
+			}
+			r.reduce();
+			return r.try_knuth_mul(b.reduce());
+		case Opcode::div:
+		{
+			if (can_neg<W>(b.numerator()))
+			{
+				const bool negative = b.numerator() < W(0);
+				const W n = negative ? -b.denominator() : b.denominator();
+				const W d = negative ? -b.numerator() : b.numerator();
+				if (can_mul<W>(r.numerator(), n) && can_mul<W>(r.denominator(), d))
+				{
+					r = F(r.numerator() * n, r.denominator() * d);
+					return true;
+				}
+			}
+			r.reduce();
+			b.reduce();
+			if (b.numerator() > W(0))
+			{
+				return r.try_knuth_mul(F::from_reduced(b.denominator(), b.numerator()));
+			}
+			return can_neg<W>(b.numerator()) && r.try_knuth_mul(F::from_reduced(-b.denominator(), -b.numerator()));
+		}
+		case Opcode::mod:
+		{
+			const W g = gcd<W>(r.denominator(), b.denominator());
+			const W s = b.denominator() / g;
+			const W t = r.denominator() / g;
+			if (!can_mul<W>(r.numerator(), s) || !can_mul<W>(b.numerator(), t) || !can_mul<W>(r.denominator(), s))
+			{
+				return false;
+			}
+			const W y = b.numerator() * t;
+			r = F(y == W(-1) ? W(0) : r.numerator() * s % y, r.denominator() * s);
+			return true;
+		}
+		case Opcode::neg:
+			if (!can_neg<W>(r.numerator()))
+			{
+				r.reduce();
+				if (!can_neg<W>(r.numerator()))
+				{
+					return false;
+				}
+			}
+			r = r.reduced() ? F::from_reduced(-r.numerator(), r.denominator()) : F(-r.numerator(), r.denominator());
+			return true;
+	}
+	return true;
+}
+
+// Errors are reported through the returned status without throwing, so a
+// failing row costs no more than a passing one. Types up to 32 bits compute in
+// int64_t, where no intermediate can overflow, and the result is reduced only
+// when it does not fit in T.
+template <Fraction_compatible T>
+Status Program<T>::run (std::vector<Fraction<T>>& regs) const
+{
+	using F = Fraction<T>;
+	for (const Instruction& i : _instructions)
+	{
+		const F& a = regs[i.a];
+		const F& b = regs[i.b];
+		if ((i.op == Opcode::div || i.op == Opcode::mod) && b.numerator() == T(0))
+		{
+			return Status::division_by_zero;
+		}
+		if constexpr (std::integral<T> && sizeof(T) <= 4)
+		{
+			using W = Fraction<int64_t>;
+			const auto fits = [] (const W& w)
+			{
+				return w.numerator() >= std::numeric_limits<T>::min() && w.numerator() <= std::numeric_limits<T>::max()
+					&& w.denominator() <= std::numeric_limits<T>::max();
+			};
+			const auto widen = [] (const F& f)
+			{
+				return f.reduced() ? W::from_reduced(f.numerator(), f.denominator()) : W(f.numerator(), f.denominator());
+			};
+			W r = widen(a);
+			apply(i.op, r, widen(b));
+			if (!fits(r) && !fits(r.reduce()))
+			{
+				return Status::overflow;
+			}
+			const T n = T(r.numerator());
+			const T d = T(r.denominator());
+			regs[i.dst] = r.reduced() ? F::from_reduced(n, d) : F(n, d);
+		}
+		else
+		{
+			F r = a;
+			if (!apply(i.op, r, b))
+			{
+				return Status::overflow;
+			}
+			regs[i.dst] = r;
+		}
+	}
+	return Status::ok;
+}
+
+template <Fraction_compatible T>
+std::vector<Fraction<T>> Program<T>::make_registers () const
+{
+	std::vector<Fraction<T>> regs(_registers);
+	std::copy(_constants.begin(), _constants.end(), regs.begin() + _variables.size());
+	return regs;
+}
+
+}
@@ -0,0 +1,101 @@
+#ifndef TOKOX_FRACTIONS_EXPR
+#define TOKOX_FRACTIONS_EXPR
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+#include <stdexcept>
+#include <exception>
+#include <atomic>
+#include <thread>
+#include <mutex>
+
+#include "fractions.hpp"
+
+namespace tokox::expr
+{
+
+class ExpressionError : public std::invalid_argument
+{
+public:
+	ExpressionError (const std::string& what, const std::size_t position):
+		std::invalid_argument(what + " at position " + std::to_string(position) + " in tokox::expr::Program"),
+		_position(position)
+	{}
+
+	std::size_t position () const
+	{
+		return _position;
+	}
+
+private:
+	std::size_t _position;
+};
+
+enum class Status : uint8_t
+{
+	ok,
+	overflow,
+	division_by_zero
+};
+
+enum class Opcode : uint8_t
+{
+	add,
+	sub,
+	mul,
+	div,
+	mod,
+	neg
+};
+
+struct Instruction
+{
+	Opcode op;
+	uint16_t dst;
+	uint16_t a;
+	uint16_t b;
+};
+
+template <Fraction_compatible T = int>
+class Program
+{
+public:
+	explicit Program (const std::string& source);
+
+
+	Status evaluate (std::span<const Fraction<T>> inputs, Fraction<T>& result) const;
+
+	void evaluate (std::span<const std::span<const Fraction<T>>> columns,
+		std::span<Fraction<T>> results,
+		std::span<Status> statuses,
+		const unsigned threads = 1) const;
+
+
+	const std::vector<std::string>& variables () const;
+	const std::vector<Instruction>& instructions () const;
+	const std::vector<Fraction<T>>& constants () const;
+	std::size_t registers () const;
+
+	static constexpr std::size_t chunk_size = 4096;
+
+private:
+	template <Fraction_compatible W>
+	static bool apply (const Opcode op, Fraction<W>& r, const Fraction<W>& b);
+	Status run (std::vector<Fraction<T>>& regs) const;
+	std::vector<Fraction<T>> make_registers () const;
+
+	std::vector<std::string> _variables;
+	std::vector<Fraction<T>> _constants;
+	std::vector<Instruction> _instructions;
+	std::size_t _registers;
+	uint16_t _result;
+};
+
+}
+
+#include "expr.cpp"
+
+#endif
@@ -0,0 +1,305 @@
+#include "fixed_fraction.hpp"
+namespace tokox
+{
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D>::FixedFraction (const T n):
+	_numerator(n)
+{}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D>::FixedFraction (const Fraction<T>& f):
+	_numerator(T(0))
+{
+	f.reduce();
+	if (D % f.denominator() != T(0))
+	{
+		throw FractionInexactError<T>("FixedFraction::FixedFraction");
+	}
+	const T scale = D / f.denominator();
+	if (!can_mul<T>(f.numerator(), scale))
+	{
+		throw FractionOverflowError<T>("FixedFraction::FixedFraction");
+	}
+	_numerator = f.numerator() * scale;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D> FixedFraction<T, D>::from_integer (const T v)
+{
+	if (!can_mul<T>(v, D))
+	{
+		throw FractionOverflowError<T>("FixedFraction::from_integer");
+	}
+	return FixedFraction(v * D);
+}
+
+
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D>& FixedFraction<T, D>::operator+= (const FixedFraction& other)
+{
+	if (!can_add<T>(_numerator, other._numerator))
+	{
+		throw FractionOverflowError<T>("FixedFraction::operator+=");
+	}
+	_numerator += other._numerator;
+	return *this;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D> FixedFraction<T, D>::operator+ (const FixedFraction& other) const
+{
+	return FixedFraction(*this) += other;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D> FixedFraction<T, D>::operator+ () const
+{
+	return FixedFraction(*this);
+}
+
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D>& FixedFraction<T, D>::operator-= (const FixedFraction& other)
+{
+	if (!can_sub<T>(_numerator, other._numerator))
+	{
+		throw FractionOverflowError<T>("FixedFraction::operator-=");
+	}
+	_numerator -= other._numerator;
+	return *this;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D> FixedFraction<T, D>::operator- (const FixedFraction& other) const
+{
+	return FixedFraction(*this) -= other;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D> FixedFraction<T, D>::operator- () const
+{
+	if (!can_neg<T>(_numerator))
+	{
+		throw FractionOverflowError<T>("FixedFraction::operator-");
+	}
+	return FixedFraction(-_numerator);
+}
+
+
+// The product of two values with denominator D has denominator D * D, so it is
+// truncated toward zero back to a multiple of 1 / D. D is a compile time
+// constant, so the division compiles to a multiply and shift.
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D>& FixedFraction<T, D>::operator*= (const FixedFraction& other)
+{
+	if (can_mul<T>(_numerator, other._numerator))
+	{
+		_numerator = (_numerator * other._numerator) / D;
+		return *this;
+	}
+	const T q = _numerator / D;
+	const T r = _numerator % D;
+	if (can_mul<T>(q, other._numerator)
+		&& can_mul<T>(r, other._numerator)
+		&& can_add<T>(q * other._numerator, (r * other._numerator) / D))
+	{
+		_numerator = q * other._numerator + (r * other._numerator) / D;
+		return *this;
+	}
+	throw FractionOverflowError<T>("FixedFraction::operator*=");
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D> FixedFraction<T, D>::operator* (const FixedFraction& other) const
+{
+	return FixedFraction(*this) *= other;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D>& FixedFraction<T, D>::operator*= (const T& other)
+{
+	if (!can_mul<T>(_numerator, other))
+	{
+		throw FractionOverflowError<T>("FixedFraction::operator*=");
+	}
+	_numerator *= other;
+	return *this;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D> FixedFraction<T, D>::operator* (const T& other) const
+{
+	return FixedFraction(*this) *= other;
+}
+
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D>& FixedFraction<T, D>::operator/= (const FixedFraction& other)
+{
+	if (other._numerator == T(0))
+	{
+		throw FractionDenominatorIsZeroError<T>("FixedFraction::operator/=");
+	}
+	if (can_mul<T>(_numerator, D))
+	{
+		_numerator = (_numerator * D) / other._numerator;
+		return *this;
+	}
+	const T q = _numerator / other._numerator;
+	const T r = _numerator % other._numerator;
+	if (can_mul<T>(q, D)
+		&& can_mul<T>(r, D)
+		&& can_add<T>(q * D, (r * D) / other._numerator))
+	{
+		_numerator = q * D + (r * D) / other._numerator;
+		return *this;
+	}
+	throw FractionOverflowError<T>("FixedFraction::operator/=");
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D> FixedFraction<T, D>::operator/ (const FixedFraction& other) const
+{
+	return FixedFraction(*this) /= other;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D>& FixedFraction<T, D>::operator/= (const T& other)
+{
+	if (other == T(0))
+	{
+		throw FractionDenominatorIsZeroError<T>("FixedFraction::operator/=");
+	}
+	if (other == T(-1) && !can_neg<T>(_numerator))
+	{
+		throw FractionOverflowError<T>("FixedFraction::operator/=");
+	}
+	_numerator /= other;
+	return *this;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D> FixedFraction<T, D>::operator/ (const T& other) const
+{
+	return FixedFraction(*this) /= other;
+}
+
+
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+bool FixedFraction<T, D>::operator== (const FixedFraction& other) const
+{
+	return _numerator == other._numerator;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+bool FixedFraction<T, D>::operator!= (const FixedFraction& other) const
+{
+	return _numerator != other._numerator;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+bool FixedFraction<T, D>::operator> (const FixedFraction& other) const
+{
+	return _numerator > other._numerator;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+bool FixedFraction<T, D>::operator>= (const FixedFraction& other) const
+{
+	return _numerator >= other._numerator;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+bool FixedFraction<T, D>::operator< (const FixedFraction& other) const
+{
+	return _numerator < other._numerator;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+bool FixedFraction<T, D>::operator<= (const FixedFraction& other) const
+{
+	return _numerator <= other._numerator;
+}
+
+
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+FixedFraction<T, D>::operator Fraction<T> () const
+{
+	return Fraction<T>(_numerator, D);
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+T FixedFraction<T, D>::value () const
+{
+	return _numerator / D;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+T FixedFraction<T, D>::numerator () const
+{
+	return _numerator;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+void FixedFraction<T, D>::numerator (const T n)
+{
+	_numerator = n;
+}
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+constexpr T FixedFraction<T, D>::denominator ()
+{
+	return D;
+}
+
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+void FixedFraction<T, D>::swap (FixedFraction& other)
+{
+	const T tmp = _numerator;
+	_numerator = other._numerator;
+	other._numerator = tmp;
+}
+
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+std::size_t FixedFraction<T, D>::hash () const requires Hashable<T>
+{
+	return Fraction<T>(*this).hash();
+}
+
+}
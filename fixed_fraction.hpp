@@ -0,0 +1,74 @@
+#ifndef TOKOX_FRACTIONS_FIXED_FRACTION
+#define TOKOX_FRACTIONS_FIXED_FRACTION
+
+#include <cstddef>
+#include <functional>
+
+#include "fractions.hpp"
+
+namespace tokox
+{
+
+template <Fraction_compatible T, T D>
+	requires (D > T(0))
+class FixedFraction
+{
+public:
+	explicit FixedFraction (const T n = T(0));
+	explicit FixedFraction (const Fraction<T>& f);
+
+	static FixedFraction from_integer (const T v);
+
+
+	FixedFraction& operator+= (const FixedFraction& other);
+	FixedFraction operator+ (const FixedFraction& other) const;
+	FixedFraction operator+ () const;
+
+	FixedFraction& operator-= (const FixedFraction& other);
+	FixedFraction operator- (const FixedFraction& other) const;
+	FixedFraction operator- () const;
+
+	FixedFraction& operator*= (const FixedFraction& other);
+	FixedFraction operator* (const FixedFraction& other) const;
+	FixedFraction& operator*= (const T& other);
+	FixedFraction operator* (const T& other) const;
+
+	FixedFraction& operator/= (const FixedFraction& other);
+	FixedFraction operator/ (const FixedFraction& other) const;
+	FixedFraction& operator/= (const T& other);
+	FixedFraction operator/ (const T& other) const;
+
+
+	bool operator== (const FixedFraction& other) const;
+	bool operator!= (const FixedFraction& other) const;
+
+	bool operator> (const FixedFraction& other) const;
+	bool operator>= (const FixedFraction& other) const;
+
+	bool operator< (const FixedFraction& other) const;
+	bool operator<= (const FixedFraction& other) const;
+
+
+	operator Fraction<T> () const;
+
+	T value () const;
+
+	T numerator () const;
+	void numerator (const T n);
+
+	static constexpr T denominator ();
+
+
+	void swap (FixedFraction& other);
+
+	std::size_t hash () const requires Hashable<T>;
+
+private:
+	T _numerator;
+};
+
+}
+
+#include "fixed_fraction.cpp"
+
+#endif
@@ -0,0 +1,365 @@
+#include "fraction_index.hpp"
+namespace tokox
+{
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+FractionIndex<T>::FractionIndex (const std::string& path):
+	_mapping(nullptr),
+	_length(0)
+{
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		throw FractionIndexError("cannot open " + path);
+	}
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(Header))
+	{
+		::close(fd);
+		throw FractionIndexError("truncated file " + path);
+	}
+	_length = st.st_size;
+	_mapping = ::mmap(nullptr, _length, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (_mapping == MAP_FAILED)
+	{
+		_mapping = nullptr;
+		throw FractionIndexError("cannot map " + path);
+	}
+	const char* base = static_cast<const char*>(_mapping);
+	Header h;
+	std::memcpy(&h, base, sizeof(h));
+	const auto fits = [this] (const uint64_t offset, const uint64_t count, const std::size_t size)
+	{
+		return offset % 64 == 0 && offset <= _length && count <= (_length - offset) / size;
+	};
+	if (std::memcmp(h.magic, "TOKOXFIX", 8) != 0 || h.version != version || h.endian != 0x01020304
+		|| h.key_size != sizeof(T) || h.block_size != block_size || h.file_size != _length
+		|| h.top_count != (h.count + block_size - 1) / block_size
+		|| !fits(h.numerators, h.count, sizeof(T)) || !fits(h.denominators, h.count, sizeof(T))
+		|| !fits(h.payloads, h.count, sizeof(uint64_t))
+		|| !fits(h.top_keys, h.top_count + 1, sizeof(double)) || !fits(h.top_ranks, h.top_count + 1, sizeof(uint64_t)))
+	{
+		::munmap(_mapping, _length);
+		_mapping = nullptr;
+		throw FractionIndexError("bad header in " + path);
+	}
+	_count = h.count;
+	_top_count = h.top_count;
+	_numerators = reinterpret_cast<const T*>(base + h.numerators);
+	_denominators = reinterpret_cast<const T*>(base + h.denominators);
+	_payloads = reinterpret_cast<const uint64_t*>(base + h.payloads);
+	_top_keys = reinterpret_cast<const double*>(base + h.top_keys);
+	_top_ranks = reinterpret_cast<const uint64_t*>(base + h.top_ranks);
+}
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+FractionIndex<T>::~FractionIndex ()
+{
+	if (_mapping != nullptr)
+	{
+		::munmap(_mapping, _length);
+	}
+}
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+FractionIndex<T>::FractionIndex (FractionIndex&& other) noexcept:
+	_mapping(std::exchange(other._mapping, nullptr)),
+	_length(std::exchange(other._length, 0)),
+	_count(std::exchange(other._count, 0)),
+	_top_count(std::exchange(other._top_count, 0)),
+	_numerators(other._numerators),
+	_denominators(other._denominators),
+	_payloads(other._payloads),
+	_top_keys(other._top_keys),
+	_top_ranks(other._top_ranks)
+{}
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+FractionIndex<T>& FractionIndex<T>::operator= (FractionIndex&& other) noexcept
+{
+	std::swap(_mapping, other._mapping);
+	std::swap(_length, other._length);
+	std::swap(_count, other._count);
+	std::swap(_top_count, other._top_count);
+	std::swap(_numerators, other._numerators);
+	std::swap(_denominators, other._denominators);
+	std::swap(_payloads, other._payloads);
+	std::swap(_top_keys, other._top_keys);
+	std::swap(_top_ranks, other._top_ranks);
+	return *this;
+}
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+void FractionIndex<T>::write (const std::string& path, std::span<const Fraction<T>> keys, std::span<const uint64_t> payloads)
+{
+	if (keys.size() != payloads.size())
+	{
+		throw std::invalid_argument("span sizes differ in tokox::FractionIndex::write");
+	}
+	const std::size_t count = keys.size();
+	std::vector<T> numerators(count);
+	std::vector<T> denominators(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		keys[i].reduce();
+		numerators[i] = keys[i].numerator();
+		denominators[i] = keys[i].denominator();
+	}
+	std::vector<std::size_t> order(count);
+	std::iota(order.begin(), order.end(), std::size_t(0));
+	std::stable_sort(order.begin(), order.end(), [&] (const std::size_t a, const std::size_t b)
+	{
+		return compare(numerators[a], denominators[a], numerators[b], denominators[b]) < 0;
+	});
+
+	const std::size_t top_count = (count + block_size - 1) / block_size;
+	std::vector<double> samples(top_count);
+	for (std::size_t j = 0; j < top_count; ++j)
+	{
+		const std::size_t i = order[j * block_size];
+		samples[j] = approximate(numerators[i], denominators[i]);
+	}
+	// Eytzinger layout: node k has children 2k and 2k + 1, node 0 is unused.
+	std::vector<double> top_keys(top_count + 1, 0.0);
+	std::vector<uint64_t> top_ranks(top_count + 1, 0);
+	std::size_t next = 0;
+	const auto fill = [&] (const auto& self, const std::size_t k) -> void
+	{
+		if (k <= top_count)
+		{
+			self(self, 2 * k);
+			top_keys[k] = samples[next];
+			top_ranks[k] = next++;
+			self(self, 2 * k + 1);
+		}
+	};
+	fill(fill, 1);
+
+	const auto align = [] (const uint64_t offset)
+	{
+		return (offset + 63) / 64 * 64;
+	};
+	Header h{};
+	std::memcpy(h.magic, "TOKOXFIX", 8);
+	h.version = version;
+	h.endian = 0x01020304;
+	h.key_size = sizeof(T);
+	h.block_size = block_size;
+	h.count = count;
+	h.top_count = top_count;
+	h.numerators = align(sizeof(Header));
+	h.denominators = align(h.numerators + count * sizeof(T));
+	h.payloads = align(h.denominators + count * sizeof(T));
+	h.top_keys = align(h.payloads + count * sizeof(uint64_t));
+	h.top_ranks = align(h.top_keys + (top_count + 1) * sizeof(double));
+	h.file_size = align(h.top_ranks + (top_count + 1) * sizeof(uint64_t));
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	uint64_t written = 0;
+	const auto put = [&] (const uint64_t offset, const void* data, const std::size_t bytes)
+	{
+		static const char zeros[64] = {};
+		out.write(zeros, offset - written);
+		out.write(static_cast<const char*>(data), bytes);
+		written = offset + bytes;
+	};
+	std::vector<T> sorted(count);
+	std::vector<uint64_t> sorted_payloads(count);
+	put(0, &h, sizeof(h));
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		sorted[i] = numerators[order[i]];
+	}
+	put(h.numerators, sorted.data(), count * sizeof(T));
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		sorted[i] = denominators[order[i]];
+		sorted_payloads[i] = payloads[order[i]];
+	}
+	put(h.denominators, sorted.data(), count * sizeof(T));
+	put(h.payloads, sorted_payloads.data(), count * sizeof(uint64_t));
+	put(h.top_keys, top_keys.data(), top_keys.size() * sizeof(double));
+	put(h.top_ranks, top_ranks.data(), top_ranks.size() * sizeof(uint64_t));
+	put(h.file_size, nullptr, 0);
+	if (!out.flush())
+	{
+		throw FractionIndexError("cannot write " + path);
+	}
+}
+
+
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t FractionIndex<T>::lower_bound (const Fraction<T>& f) const
+{
+	return search<false>(f);
+}
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t FractionIndex<T>::upper_bound (const Fraction<T>& f) const
+{
+	return search<true>(f);
+}
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::pair<std::size_t, std::size_t> FractionIndex<T>::range (const Fraction<T>& low, const Fraction<T>& high) const
+{
+	const std::size_t begin = lower_bound(low);
+	return {begin, std::max(begin, upper_bound(high))};
+}
+
+// Ties go to the smaller key and an empty index gives size(), as lower_bound
+// does. The differences to both neighbours fit in __int128 and are compared
+// exactly by their continued fractions.
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t FractionIndex<T>::nearest (const Fraction<T>& f) const
+{
+	const std::size_t i = lower_bound(f);
+	if (_count == 0)
+	{
+		return _count;
+	}
+	if (i == 0)
+	{
+		return 0;
+	}
+	if (i == _count)
+	{
+		return _count - 1;
+	}
+	const Fraction<T> below = key(i - 1);
+	const Fraction<T> above = key(i);
+#ifdef __SIZEOF_INT128__
+	using W = __int128;
+	const W up = W(above.numerator()) * f.denominator() - W(f.numerator()) * above.denominator();
+	const W down = W(f.numerator()) * below.denominator() - W(below.numerator()) * f.denominator();
+	return compare_positive<W>(up, W(above.denominator()) * f.denominator(), down, W(below.denominator()) * f.denominator()) < 0 ? i : i - 1;
+#else
+	try
+	{
+		return above - f < f - below ? i : i - 1;
+	}
+	catch (FractionOverflowError<T>&)
+	{
+		const long double x = static_cast<long double>(f.numerator()) / f.denominator();
+		const long double a = static_cast<long double>(below.numerator()) / below.denominator();
+		const long double b = static_cast<long double>(above.numerator()) / above.denominator();
+		return b - x < x - a ? i : i - 1;
+	}
+#endif
+}
+
+
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t FractionIndex<T>::size () const
+{
+	return _count;
+}
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+Fraction<T> FractionIndex<T>::key (const std::size_t i) const
+{
+	return Fraction<T>(_numerators[i], _denominators[i]);
+}
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+uint64_t FractionIndex<T>::payload (const std::size_t i) const
+{
+	return _payloads[i];
+}
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::span<const uint64_t> FractionIndex<T>::payloads (const std::size_t begin, const std::size_t end) const
+{
+	return std::span<const uint64_t>(_payloads + begin, _payloads + end);
+}
+
+
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+double FractionIndex<T>::approximate (const T n, const T d)
+{
+	return static_cast<double>(static_cast<long double>(n) / static_cast<long double>(d));
+}
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+int FractionIndex<T>::compare (const T n1, const T d1, const T n2, const T d2)
+{
+#ifdef __SIZEOF_INT128__
+	const __int128 left = static_cast<__int128>(n1) * d2;
+	const __int128 right = static_cast<__int128>(n2) * d1;
+	return left < right ? -1 : (right < left ? 1 : 0);
+#else
+	const Fraction<T> a(n1, d1);
+	const Fraction<T> b(n2, d2);
+	return a < b ? -1 : (b < a ? 1 : 0);
+#endif
+}
+
+// Number of top level samples below a (or not above a when strict).
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+std::size_t FractionIndex<T>::first_block (const double a, const bool strict) const
+{
+	std::size_t k = 1;
+	while (k <= _top_count)
+	{
+		k = 2 * k + (strict ? _top_keys[k] <= a : _top_keys[k] < a);
+	}
+	k >>= std::countr_one(k) + 1;
+	return k == 0 ? _top_count : _top_ranks[k];
+}
+
+// Keys whose double is below that of f are smaller than f and keys whose
+// double is above it are larger, so only the blocks between the first sample
+// not below and the first sample above need exact comparisons.
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+template <bool Upper>
+std::size_t FractionIndex<T>::search (const Fraction<T>& f) const
+{
+	if (_count == 0)
+	{
+		return 0;
+	}
+	const T n = f.numerator();
+	const T d = f.denominator();
+	const double a = approximate(n, d);
+	const std::size_t low_block = first_block(a, false);
+	const std::size_t high_block = first_block(a, true);
+	std::size_t low = low_block == 0 ? 0 : (low_block - 1) * block_size + 1;
+	std::size_t high = high_block == _top_count ? _count : high_block * block_size;
+	while (low < high)
+	{
+		const std::size_t mid = low + (high - low) / 2;
+		const int c = compare(_numerators[mid], _denominators[mid], n, d);
+		if (Upper ? c <= 0 : c < 0)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return low;
+}
+
+}
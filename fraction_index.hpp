@@ -0,0 +1,111 @@
+#ifndef TOKOX_FRACTIONS_FRACTION_INDEX
+#define TOKOX_FRACTIONS_FRACTION_INDEX
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <fstream>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fractions.hpp"
+
+namespace tokox
+{
+
+class FractionIndexError : public std::runtime_error
+{
+public:
+	FractionIndexError (const std::string& what):
+		std::runtime_error(what + " in tokox::FractionIndex")
+	{}
+};
+
+// Read-only sorted index of fractions in one memory mapped file: numerator,
+// denominator and payload columns plus an Eytzinger ordered top level with
+// the double value of every block_size-th key. Doubles of n/d are monotone in
+// n/d for keys of up to 64 bits, so the top level narrows a search to a few
+// blocks and exact comparisons settle the rest. All queries are const and
+// touch only the mapping, so any number of threads can share one index.
+template <Fraction_compatible T = int64_t>
+	requires (std::integral<T> && sizeof(T) <= 8)
+class FractionIndex
+{
+public:
+	explicit FractionIndex (const std::string& path);
+	~FractionIndex ();
+
+	FractionIndex (const FractionIndex&) = delete;
+	FractionIndex& operator= (const FractionIndex&) = delete;
+	FractionIndex (FractionIndex&& other) noexcept;
+	FractionIndex& operator= (FractionIndex&& other) noexcept;
+
+	static void write (const std::string& path, std::span<const Fraction<T>> keys, std::span<const uint64_t> payloads);
+
+
+	std::size_t lower_bound (const Fraction<T>& f) const;
+	std::size_t upper_bound (const Fraction<T>& f) const;
+	std::pair<std::size_t, std::size_t> range (const Fraction<T>& low, const Fraction<T>& high) const;
+	std::size_t nearest (const Fraction<T>& f) const;
+
+
+	std::size_t size () const;
+	Fraction<T> key (const std::size_t i) const;
+	uint64_t payload (const std::size_t i) const;
+	std::span<const uint64_t> payloads (const std::size_t begin, const std::size_t end) const;
+
+	static constexpr uint32_t block_size = 64;
+	static constexpr uint32_t version = 1;
+
+private:
+	struct Header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t endian;
+		uint32_t key_size;
+		uint32_t block_size;
+		uint64_t count;
+		uint64_t top_count;
+		uint64_t numerators;
+		uint64_t denominators;
+		uint64_t payloads;
+		uint64_t top_keys;
+		uint64_t top_ranks;
+		uint64_t file_size;
+	};
+
+	static double approximate (const T n, const T d);
+	static int compare (const T n1, const T d1, const T n2, const T d2);
+	std::size_t first_block (const double a, const bool strict) const;
+	template <bool Upper>
+	std::size_t search (const Fraction<T>& f) const;
+
+	void* _mapping;
+	std::size_t _length;
+	std::size_t _count;
+	std::size_t _top_count;
+	const T* _numerators;
+	const T* _denominators;
+	const uint64_t* _payloads;
+	const double* _top_keys;
+	const uint64_t* _top_ranks;
+};
+
+}
+
+#include "fraction_index.cpp"
+
+#endif
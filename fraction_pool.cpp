@@ -0,0 +1,277 @@
+#include "fraction_pool.hpp"
+namespace tokox
+{
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+FractionPool<T, Shards>::FractionPool ():
+	_shards(new Shard[Shards])
+{}
+
+
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+FractionHandle FractionPool<T, Shards>::intern (const Fraction<T>& f)
+{
+	const Entry e = canonical(f);
+	const uint64_t hash = hash_of(e);
+	const std::size_t shard = shard_of(hash);
+	Shard& s = _shards[shard];
+	std::lock_guard<std::mutex> lock(s.mutex);
+	const std::optional<uint32_t> found = lookup(s, e, uint32_t(hash));
+	return handle(shard, found ? *found : insert(s, e, uint32_t(hash)));
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+void FractionPool<T, Shards>::intern (std::span<const Fraction<T>> fractions, std::span<FractionHandle> handles)
+{
+	if (fractions.size() != handles.size())
+	{
+		throw std::invalid_argument("span sizes differ in tokox::FractionPool::intern");
+	}
+	std::vector<Entry> entries(fractions.size());
+	std::vector<uint64_t> hashes(fractions.size());
+	std::vector<std::size_t> starts(Shards + 1, 0);
+	for (std::size_t i = 0; i < fractions.size(); ++i)
+	{
+		entries[i] = canonical(fractions[i]);
+		hashes[i] = hash_of(entries[i]);
+		++starts[shard_of(hashes[i]) + 1];
+	}
+	for (std::size_t s = 0; s < Shards; ++s)
+	{
+		starts[s + 1] += starts[s];
+	}
+	std::vector<std::size_t> order(fractions.size());
+	std::vector<std::size_t> next(starts.begin(), starts.end() - 1);
+	for (std::size_t i = 0; i < fractions.size(); ++i)
+	{
+		order[next[shard_of(hashes[i])]++] = i;
+	}
+	for (std::size_t shard = 0; shard < Shards; ++shard)
+	{
+		if (starts[shard] == starts[shard + 1])
+		{
+			continue;
+		}
+		Shard& s = _shards[shard];
+		std::lock_guard<std::mutex> lock(s.mutex);
+		for (std::size_t k = starts[shard]; k < starts[shard + 1]; ++k)
+		{
+			const std::size_t i = order[k];
+			const std::optional<uint32_t> found = lookup(s, entries[i], uint32_t(hashes[i]));
+			handles[i] = handle(shard, found ? *found : insert(s, entries[i], uint32_t(hashes[i])));
+		}
+	}
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+std::optional<FractionHandle> FractionPool<T, Shards>::find (const Fraction<T>& f) const
+{
+	const Entry e = canonical(f);
+	const uint64_t hash = hash_of(e);
+	const std::size_t shard = shard_of(hash);
+	const Shard& s = _shards[shard];
+	std::lock_guard<std::mutex> lock(s.mutex);
+	const std::optional<uint32_t> found = lookup(s, e, uint32_t(hash));
+	if (!found)
+	{
+		return std::nullopt;
+	}
+	return handle(shard, *found);
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+Fraction<T> FractionPool<T, Shards>::get (const FractionHandle h) const
+{
+	const std::size_t shard = shard_bits == 0 ? 0 : h.value() >> (32 - shard_bits);
+	const std::size_t index = h.value() & (shard_capacity - 1);
+	const Shard& s = _shards[shard];
+	if (index >= s.size.load(std::memory_order_acquire))
+	{
+		throw std::out_of_range("unknown handle in tokox::FractionPool::get");
+	}
+	const Entry& e = entry(s, index);
+	return Fraction<T>::from_reduced(e.numerator, e.denominator);
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+Fraction<T> FractionPool<T, Shards>::operator[] (const FractionHandle h) const
+{
+	return get(h);
+}
+
+
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+std::size_t FractionPool<T, Shards>::size () const
+{
+	std::size_t total = 0;
+	for (std::size_t i = 0; i < Shards; ++i)
+	{
+		total += _shards[i].size.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+FractionPoolStats FractionPool<T, Shards>::stats () const
+{
+	FractionPoolStats st{0, 0, 0, 0, sizeof(*this) + Shards * sizeof(Shard)};
+	for (std::size_t i = 0; i < Shards; ++i)
+	{
+		const Shard& s = _shards[i];
+		std::lock_guard<std::mutex> lock(s.mutex);
+		const std::size_t values = s.size.load(std::memory_order_relaxed);
+		st.values += values;
+		st.value_bytes += values * sizeof(Entry);
+		st.reserved_value_bytes += (s.owned.empty() ? 0 : chunk_begin(s.owned.size()) - chunk_begin(0)) * sizeof(Entry);
+		st.index_bytes += s.slots.capacity() * sizeof(Slot);
+	}
+	st.total_bytes += st.reserved_value_bytes + st.index_bytes;
+	return st;
+}
+
+
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+typename FractionPool<T, Shards>::Entry FractionPool<T, Shards>::canonical (const Fraction<T>& f)
+{
+	f.reduce();
+	return Entry{f.numerator(), f.denominator()};
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+uint64_t FractionPool<T, Shards>::hash_of (const Entry& e)
+{
+	uint64_t h = uint64_t(std::hash<T>()(e.numerator)) * 0x9e3779b97f4a7c15ULL + uint64_t(std::hash<T>()(e.denominator));
+	h ^= h >> 30;
+	h *= 0xbf58476d1ce4e5b9ULL;
+	h ^= h >> 27;
+	h *= 0x94d049bb133111ebULL;
+	h ^= h >> 31;
+	return h;
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+std::size_t FractionPool<T, Shards>::shard_of (const uint64_t hash)
+{
+	return shard_bits == 0 ? 0 : std::size_t(hash >> (64 - shard_bits));
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+std::size_t FractionPool<T, Shards>::chunk_of (const std::size_t index)
+{
+	return std::bit_width(index + first_chunk) - std::bit_width(first_chunk);
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+std::size_t FractionPool<T, Shards>::chunk_begin (const std::size_t chunk)
+{
+	return (first_chunk << chunk) - first_chunk;
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+const typename FractionPool<T, Shards>::Entry& FractionPool<T, Shards>::entry (const Shard& s, const std::size_t index) const
+{
+	const std::size_t chunk = chunk_of(index);
+	return s.chunks[chunk].load(std::memory_order_acquire)[index - chunk_begin(chunk)];
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+std::optional<uint32_t> FractionPool<T, Shards>::lookup (const Shard& s, const Entry& e, const uint32_t hash) const
+{
+	if (s.slots.empty())
+	{
+		return std::nullopt;
+	}
+	const std::size_t mask = s.slots.size() - 1;
+	for (std::size_t i = hash & mask; s.slots[i].index != 0; i = (i + 1) & mask)
+	{
+		if (s.slots[i].hash == hash)
+		{
+			const Entry& candidate = entry(s, s.slots[i].index - 1);
+			if (candidate.numerator == e.numerator && candidate.denominator == e.denominator)
+			{
+				return s.slots[i].index - 1;
+			}
+		}
+	}
+	return std::nullopt;
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+uint32_t FractionPool<T, Shards>::insert (Shard& s, const Entry& e, const uint32_t hash)
+{
+	const std::size_t index = s.size.load(std::memory_order_relaxed);
+	if (index + 1 >= shard_capacity)
+	{
+		throw FractionPoolFullError("FractionPool::intern");
+	}
+	if ((index + 1) * 4 > s.slots.size() * 3)
+	{
+		grow(s);
+	}
+	const std::size_t chunk = chunk_of(index);
+	if (chunk == s.owned.size())
+	{
+		s.owned.emplace_back(new Entry[first_chunk << chunk]);
+		s.chunks[chunk].store(s.owned.back().get(), std::memory_order_release);
+	}
+	s.owned.back()[index - chunk_begin(chunk)] = e;
+	s.size.store(index + 1, std::memory_order_release);
+
+	const std::size_t mask = s.slots.size() - 1;
+	std::size_t i = hash & mask;
+	while (s.slots[i].index != 0)
+	{
+		i = (i + 1) & mask;
+	}
+	s.slots[i] = Slot{hash, uint32_t(index + 1)};
+	return uint32_t(index);
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+void FractionPool<T, Shards>::grow (Shard& s)
+{
+	std::vector<Slot> slots(s.slots.empty() ? 16 : s.slots.size() * 2, Slot{0, 0});
+	const std::size_t mask = slots.size() - 1;
+	for (const Slot& slot : s.slots)
+	{
+		if (slot.index != 0)
+		{
+			std::size_t i = slot.hash & mask;
+			while (slots[i].index != 0)
+			{
+				i = (i + 1) & mask;
+			}
+			slots[i] = slot;
+		}
+	}
+	s.slots.swap(slots);
+}
+
+template <Fraction_compatible T, std::size_t Shards>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+FractionHandle FractionPool<T, Shards>::handle (const std::size_t shard, const uint32_t index) const
+{
+	return FractionHandle(uint32_t((uint64_t(shard) << (32 - shard_bits)) | index));
+}
+
+}
@@ -0,0 +1,132 @@
+#ifndef TOKOX_FRACTIONS_FRACTION_POOL
+#define TOKOX_FRACTIONS_FRACTION_POOL
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "fractions.hpp"
+
+namespace tokox
+{
+
+class FractionPoolFullError : public std::length_error
+{
+public:
+	FractionPoolFullError (const std::string& what):
+		std::length_error("shard is full in tokox::FractionPool in " + what)
+	{}
+};
+
+class FractionHandle
+{
+public:
+	constexpr FractionHandle ():
+		_value(0)
+	{}
+
+	constexpr explicit FractionHandle (const uint32_t v):
+		_value(v)
+	{}
+
+	constexpr uint32_t value () const
+	{
+		return _value;
+	}
+
+	constexpr auto operator<=> (const FractionHandle&) const = default;
+
+private:
+	uint32_t _value;
+};
+
+struct FractionPoolStats
+{
+	std::size_t values;
+	std::size_t value_bytes;
+	std::size_t reserved_value_bytes;
+	std::size_t index_bytes;
+	std::size_t total_bytes;
+};
+
+// Handles keep the shard in their top bits and the position inside the shard
+// in the rest. Values are stored in chunks of doubling size that never move,
+// so get() takes no lock; interning locks only the shard the value hashes to.
+template <Fraction_compatible T, std::size_t Shards = 64>
+	requires (Hashable<T> && std::has_single_bit(Shards) && Shards <= (std::size_t(1) << 16))
+class FractionPool
+{
+public:
+	FractionPool ();
+
+	FractionPool (const FractionPool&) = delete;
+	FractionPool& operator= (const FractionPool&) = delete;
+
+
+	FractionHandle intern (const Fraction<T>& f);
+	void intern (std::span<const Fraction<T>> fractions, std::span<FractionHandle> handles);
+
+	std::optional<FractionHandle> find (const Fraction<T>& f) const;
+
+	Fraction<T> get (const FractionHandle h) const;
+	Fraction<T> operator[] (const FractionHandle h) const;
+
+
+	std::size_t size () const;
+	FractionPoolStats stats () const;
+
+	static constexpr std::size_t shards = Shards;
+	static constexpr std::size_t shard_bits = std::countr_zero(Shards);
+	static constexpr std::size_t shard_capacity = std::size_t(1) << (32 - shard_bits);
+	static constexpr std::size_t first_chunk = 64;
+
+private:
+	struct Entry
+	{
+		T numerator;
+		T denominator;
+	};
+
+	struct Slot
+	{
+		uint32_t hash;
+		uint32_t index;
+	};
+
+	struct alignas(64) Shard
+	{
+		mutable std::mutex mutex;
+		std::vector<Slot> slots;
+		std::atomic<std::size_t> size = 0;
+		std::atomic<Entry*> chunks[33 - std::countr_zero(first_chunk)] = {};
+		std::vector<std::unique_ptr<Entry[]>> owned;
+	};
+
+	static Entry canonical (const Fraction<T>& f);
+	static uint64_t hash_of (const Entry& e);
+	static std::size_t shard_of (const uint64_t hash);
+
+	static std::size_t chunk_of (const std::size_t index);
+	static std::size_t chunk_begin (const std::size_t chunk);
+	const Entry& entry (const Shard& s, const std::size_t index) const;
+	std::optional<uint32_t> lookup (const Shard& s, const Entry& e, const uint32_t hash) const;
+	uint32_t insert (Shard& s, const Entry& e, const uint32_t hash);
+	void grow (Shard& s);
+	FractionHandle handle (const std::size_t shard, const uint32_t index) const;
+
+	std::unique_ptr<Shard[]> _shards;
+};
+
+}
+
+#include "fraction_pool.cpp"
+
+#endif
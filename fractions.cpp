@@ -2,16 +2,130 @@
 namespace tokox
 {
 
-template <Fraction_compatible T>
-T common_denominator (const Fraction<T>& a,
-	const Fraction<T>& b,
+// Overflow checks as a Fraction with policy P sees them: unchecked only
+// asserts, so every fast path is taken.
+template <OverflowPolicy P, typename T>
+bool fits_add (const T& a, const T& b)
+{
+	if constexpr (P == OverflowPolicy::unchecked)
+	{
+		assert(can_add<T>(a, b));
+		return true;
+	}
+	else
+	{
+		return can_add<T>(a, b);
+	}
+}
+
+template <OverflowPolicy P, typename T>
+bool fits_sub (const T& a, const T& b)
+{
+	if constexpr (P == OverflowPolicy::unchecked)
+	{
+		assert(can_sub<T>(a, b));
+		return true;
+	}
+	else
+	{
+		return can_sub<T>(a, b);
+	}
+}
+
+template <OverflowPolicy P, typename T>
+bool fits_mul (const T& a, const T& b)
+{
+	if constexpr (P == OverflowPolicy::unchecked)
+	{
+		assert(can_mul<T>(a, b));
+		return true;
+	}
+	else
+	{
+		return can_mul<T>(a, b);
+	}
+}
+
+template <OverflowPolicy P, typename T>
+bool fits_neg (const T& a)
+{
+	if constexpr (P == OverflowPolicy::unchecked)
+	{
+		assert(can_neg<T>(a));
+		return true;
+	}
+	else
+	{
+		return can_neg<T>(a);
+	}
+}
+
+// Plain arithmetic for the unchecked and wrapping policies; wrapping takes
+// the low bits of the exact result.
+template <OverflowPolicy P, typename T>
+T raw_add (const T& a, const T& b)
+{
+	if constexpr (P == OverflowPolicy::wrapping)
+	{
+		T r;
+		__builtin_add_overflow(a, b, &r);
+		return r;
+	}
+	else
+	{
+		assert(can_add<T>(a, b));
+		return a + b;
+	}
+}
+
+template <OverflowPolicy P, typename T>
+T raw_sub (const T& a, const T& b)
+{
+	if constexpr (P == OverflowPolicy::wrapping)
+	{
+		T r;
+		__builtin_sub_overflow(a, b, &r);
+		return r;
+	}
+	else
+	{
+		assert(can_sub<T>(a, b));
+		return a - b;
+	}
+}
+
+template <OverflowPolicy P, typename T>
+T raw_mul (const T& a, const T& b)
+{
+	if constexpr (P == OverflowPolicy::wrapping)
+	{
+		T r;
+		__builtin_mul_overflow(a, b, &r);
+		return r;
+	}
+	else
+	{
+		assert(can_mul<T>(a, b));
+		return a * b;
+	}
+}
+
+template <OverflowPolicy P, typename T>
+T raw_neg (const T& a)
+{
+	return raw_sub<P, T>(T(0), a);
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+T common_denominator (const Fraction<T, P>& a,
+	const Fraction<T, P>& b,
 	std::string where = "common_denominator",
 	std::function<bool(T, T)> check = [] (T, T) { return true; }
 )
 {
-	if (can_mul<T>(a.numerator(), b.denominator())
-		&& can_mul<T>(b.numerator(), a.denominator())
-		&& can_mul<T>(a.denominator(), b.denominator())
+	if (fits_mul<P, T>(a.numerator(), b.denominator())
+		&& fits_mul<P, T>(b.numerator(), a.denominator())
+		&& fits_mul<P, T>(a.denominator(), b.denominator())
 		&& check(a.numerator() * b.denominator(), b.numerator() * a.denominator())
 		)
 	{
@@ -20,9 +134,9 @@ T common_denominator (const Fraction<T>& a,
 	if (!a.reduced())
 	{
 		a.reduce();
-		if (can_mul<T>(a.numerator(), b.denominator())
-			&& can_mul<T>(b.numerator(), a.denominator())
-			&& can_mul<T>(a.denominator(), b.denominator())
+		if (fits_mul<P, T>(a.numerator(), b.denominator())
+			&& fits_mul<P, T>(b.numerator(), a.denominator())
+			&& fits_mul<P, T>(a.denominator(), b.denominator())
 			&& check(a.numerator() * b.denominator(), b.numerator() * a.denominator())
 			)
 		{
@@ -32,9 +146,9 @@ T common_denominator (const Fraction<T>& a,
 	if (!b.reduced())
 	{
 		b.reduce();
-		if (can_mul<T>(a.numerator(), b.denominator())
-			&& can_mul<T>(b.numerator(), a.denominator())
-			&& can_mul<T>(a.denominator(), b.denominator())
+		if (fits_mul<P, T>(a.numerator(), b.denominator())
+			&& fits_mul<P, T>(b.numerator(), a.denominator())
+			&& fits_mul<P, T>(a.denominator(), b.denominator())
 			&& check(a.numerator() * b.denominator(), b.numerator() * a.denominator())
 			)
 		{
@@ -50,8 +164,8 @@ T common_denominator (const Fraction<T>& a,
 	{
 		throw FractionOverflowError<T>("common_denominator");
 	}
-	if (can_mul<T>(a.numerator(), _lcm / a.denominator())
-		&& can_mul<T>(b.numerator(), _lcm / b.denominator()))
+	if (fits_mul<P, T>(a.numerator(), _lcm / a.denominator())
+		&& fits_mul<P, T>(b.numerator(), _lcm / b.denominator()))
 	{
 		if (check(a.numerator() * (_lcm / a.denominator()), b.numerator() * (_lcm / b.denominator())))
 		{
@@ -62,18 +176,44 @@ T common_denominator (const Fraction<T>& a,
 	throw FractionOverflowError<T>("common_denominator");
 }
 
+// Compares a / b with c / d for a, c >= 0 and b, d > 0 by walking both
+// continued fraction expansions, so nothing is ever multiplied.
 template <Fraction_compatible T>
-Fraction<T>::Fraction (const T n, const T d):
+int compare_positive (T a, T b, T c, T d)
+{
+	while (true)
+	{
+		const T qa = a / b;
+		const T qc = c / d;
+		if (qa != qc)
+		{
+			return qa < qc ? -1 : 1;
+		}
+		const T ra = a % b;
+		const T rc = c % d;
+		if (ra == T(0) || rc == T(0))
+		{
+			return ra == rc ? 0 : (ra == T(0) ? -1 : 1);
+		}
+		a = d;
+		c = b;
+		b = rc;
+		d = ra;
+	}
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>::Fraction (const T n, const T d):
 	_numerator(n),
 	_denominator(d),
 	_flags(0)
 {
 	if (_denominator < T(0))
 	{
-		if (!can_neg<T>(_numerator) || !can_neg<T>(_denominator))
+		if (!fits_neg<P, T>(_numerator) || !fits_neg<P, T>(_denominator))
 		{
 			reduce();
-			if (!can_neg<T>(_numerator) || !can_neg<T>(_denominator))
+			if (!fits_neg<P, T>(_numerator) || !fits_neg<P, T>(_denominator))
 			{
 				throw FractionOverflowError<T>("Fraction::Fraction");
 			}
@@ -87,15 +227,45 @@ Fraction<T>::Fraction (const T n, const T d):
 	}
 }
 
-template<Fraction_compatible T>
-Fraction<T>::Fraction (const T n, const T d, const uint8_t f):
+template <Fraction_compatible T, OverflowPolicy P>
+template <Fraction_compatible U, OverflowPolicy Q>
+	requires ((!std::same_as<T, U> || P != Q) && std::constructible_from<T, U> && std::constructible_from<U, T>)
+Fraction<T, P>::Fraction (const Fraction<U, Q>& other):
+	_numerator(T(0)),
+	_denominator(T(1)),
+	_flags(0)
+{
+	if constexpr (!std::same_as<wider_t<T, U>, T>)
+	{
+		if (U(T(other.numerator())) != other.numerator() || U(T(other.denominator())) != other.denominator())
+		{
+			other.reduce();
+			if (U(T(other.numerator())) != other.numerator() || U(T(other.denominator())) != other.denominator())
+			{
+				throw FractionOverflowError<T>("Fraction::Fraction");
+			}
+		}
+	}
+	_numerator = T(other.numerator());
+	_denominator = T(other.denominator());
+	_flags = other.reduced() ? REDUCED : 0;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>::Fraction (const T n, const T d, const uint8_t f):
 	_numerator(n),
 	_denominator(d),
 	_flags(f)
 {}
 
-template <Fraction_compatible T>
-Fraction<T>::Fraction (const Fraction& other):
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::from_reduced (const T n, const T d)
+{
+	return Fraction(n, d, REDUCED);
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>::Fraction (const Fraction& other):
 	_numerator(other.numerator()),
 	_denominator(other.denominator()),
 	_flags(other.reduced() ? REDUCED : 0)
@@ -103,8 +273,8 @@ Fraction<T>::Fraction (const Fraction& other):
 
 
 
-template <Fraction_compatible T>
-Fraction<T>& Fraction<T>::operator= (const Fraction& other)
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator= (const Fraction& other)
 {
 	_numerator = other.numerator();
 	_denominator = other.denominator();
@@ -113,53 +283,89 @@ Fraction<T>& Fraction<T>::operator= (const Fraction& other)
 }
 
 
-template <Fraction_compatible T>
-Fraction<T>& Fraction<T>::operator+= (const Fraction& other)
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator+= (const Fraction& other)
 {
-	T common_denom = common_denominator(*this, other, "Fraction::operator+=", can_add<T>);
+	TOKOX_FRACTIONS_TRACE_OPERATION(add, *this, other.numerator(), other.denominator(), other.reduced());
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(other, '+');
+	}
+#ifdef TOKOX_FRACTIONS_CROSS_CANCELLATION
+	return henrici_add(other);
+#else
+	if constexpr (use_lookup_tables<T>)
+	{
+		if (try_widened_add(other, false))
+		{
+			return *this;
+		}
+	}
+	T common_denom = common_denominator(*this, other, "Fraction::operator+=", fits_add<P, T>);
 	_numerator = (_numerator * (common_denom / _denominator)) + (other.numerator() * (common_denom / other.denominator()));
 	_denominator = common_denom;
 	_flags &= ~REDUCED;
 	return *this;
+#endif
 }
 
-template <Fraction_compatible T>
-Fraction<T> Fraction<T>::operator+ (const Fraction& other) const
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator+ (const Fraction& other) const
 {
 	return Fraction(*this) += other;
 }
 
-template<Fraction_compatible T>
-Fraction<T> Fraction<T>::operator+ () const
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator+ () const
 {
 	reduce();
 	return Fraction(*this);
 }
 
 
-template <Fraction_compatible T>
-Fraction<T>& Fraction<T>::operator-= (const Fraction& other)
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator-= (const Fraction& other)
 {
-	T common_denom = common_denominator(*this, other, "Fraction::operator-=", can_sub<T>);
+	TOKOX_FRACTIONS_TRACE_OPERATION(sub, *this, other.numerator(), other.denominator(), other.reduced());
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(other, '-');
+	}
+#ifdef TOKOX_FRACTIONS_CROSS_CANCELLATION
+	return henrici_sub(other);
+#else
+	if constexpr (use_lookup_tables<T>)
+	{
+		if (try_widened_add(other, true))
+		{
+			return *this;
+		}
+	}
+	T common_denom = common_denominator(*this, other, "Fraction::operator-=", fits_sub<P, T>);
 	_numerator = (_numerator * (common_denom / _denominator)) - (other.numerator() * (common_denom / other.denominator()));
 	_denominator = common_denom;
 	_flags &= ~REDUCED;
 	return *this;
+#endif
 }
 
-template <Fraction_compatible T>
-Fraction<T> Fraction<T>::operator- (const Fraction& other) const
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator- (const Fraction& other) const
 {
 	return Fraction(*this) -= other;
 }
 
-template <Fraction_compatible T>
-Fraction<T> Fraction<T>::operator- () const
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator- () const
 {
-	if (!can_neg<T>(_numerator))
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return Fraction(T(0)).apply_policy(*this, '-');
+	}
+	if (!fits_neg<P, T>(_numerator))
 	{
 		reduce();
-		if (!can_neg<T>(_numerator))
+		if (!fits_neg<P, T>(_numerator))
 		{
 			throw FractionOverflowError<T>("Fraction::operator-");
 		}
@@ -168,11 +374,19 @@ Fraction<T> Fraction<T>::operator- () const
 }
 
 
-template <Fraction_compatible T>
-Fraction<T>& Fraction<T>::operator*= (const Fraction& other)
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator*= (const Fraction& other)
 {
-	if (can_mul<T>(_numerator, other.numerator())
-		&& can_mul<T>(_denominator, other.denominator()))
+	TOKOX_FRACTIONS_TRACE_OPERATION(mul, *this, other.numerator(), other.denominator(), other.reduced());
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(other, '*');
+	}
+#ifdef TOKOX_FRACTIONS_CROSS_CANCELLATION
+	return knuth_mul(other);
+#else
+	if (fits_mul<P, T>(_numerator, other.numerator())
+		&& fits_mul<P, T>(_denominator, other.denominator()))
 	{
 		_numerator *= other.numerator();
 		_denominator *= other.denominator();
@@ -182,8 +396,8 @@ Fraction<T>& Fraction<T>::operator*= (const Fraction& other)
 	if (!reduced())
 	{
 		reduce();
-		if (can_mul<T>(_numerator, other.numerator())
-			&& can_mul<T>(_denominator, other.denominator()))
+		if (fits_mul<P, T>(_numerator, other.numerator())
+			&& fits_mul<P, T>(_denominator, other.denominator()))
 		{
 			_numerator *= other.numerator();
 			_denominator *= other.denominator();
@@ -194,8 +408,8 @@ Fraction<T>& Fraction<T>::operator*= (const Fraction& other)
 	if (!other.reduced())
 	{
 		other.reduce();
-		if (can_mul<T>(_numerator, other.numerator())
-			&& can_mul<T>(_denominator, other.denominator()))
+		if (fits_mul<P, T>(_numerator, other.numerator())
+			&& fits_mul<P, T>(_denominator, other.denominator()))
 		{
 			_numerator *= other.numerator();
 			_denominator *= other.denominator();
@@ -208,8 +422,8 @@ Fraction<T>& Fraction<T>::operator*= (const Fraction& other)
 	T _gcd = gcd<T>(_numerator, other_denominator);
 	_numerator /= _gcd;
 	other_denominator /= _gcd;
-	if (can_mul<T>(_numerator, other_numerator)
-		&& can_mul<T>(_denominator, other_denominator))
+	if (fits_mul<P, T>(_numerator, other_numerator)
+		&& fits_mul<P, T>(_denominator, other_denominator))
 	{
 		_numerator *= other_numerator;
 		_denominator *= other_denominator;
@@ -219,8 +433,8 @@ Fraction<T>& Fraction<T>::operator*= (const Fraction& other)
 	_gcd = gcd<T>(_denominator, other_numerator);
 	_denominator /= _gcd;
 	other_numerator /= _gcd;
-	if (can_mul<T>(_numerator, other_numerator)
-		&& can_mul<T>(_denominator, other_denominator))
+	if (fits_mul<P, T>(_numerator, other_numerator)
+		&& fits_mul<P, T>(_denominator, other_denominator))
 	{
 		_numerator *= other_numerator;
 		_denominator *= other_denominator;
@@ -228,31 +442,42 @@ Fraction<T>& Fraction<T>::operator*= (const Fraction& other)
 		return *this;
 	}
 	throw FractionOverflowError<T>("Fraction::operator*");
+#endif
 }
 
-template <Fraction_compatible T>
-Fraction<T> Fraction<T>::operator* (const Fraction& other) const
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator* (const Fraction& other) const
 {
 	return Fraction(*this) *= other;
 }
 
 
-template <Fraction_compatible T>
-Fraction<T>& Fraction<T>::operator/= (const Fraction& other)
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator/= (const Fraction& other)
 {
+	TOKOX_FRACTIONS_TRACE_OPERATION(div, *this, other.numerator(), other.denominator(), other.reduced());
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(other, '/');
+	}
 	return (*this) *= other.inverted();
 }
 
-template <Fraction_compatible T>
-Fraction<T> Fraction<T>::operator/ (const Fraction& other) const
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator/ (const Fraction& other) const
 {
 	return Fraction(*this) /= other;
 }
 
 
-template <Fraction_compatible T>
-Fraction<T>& Fraction<T>::operator%= (const Fraction& other)
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator%= (const Fraction& other)
 {
+	TOKOX_FRACTIONS_TRACE_OPERATION(mod, *this, other.numerator(), other.denominator(), other.reduced());
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(other, '%');
+	}
 	T common_denom = common_denominator(*this, other);
 	_numerator = (_numerator * (common_denom / _denominator)) % (other.numerator() * (common_denom / other.denominator()));
 	_denominator = common_denom;
@@ -260,20 +485,198 @@ Fraction<T>& Fraction<T>::operator%= (const Fraction& other)
 	return *this;
 }
 
-template <Fraction_compatible T>
-Fraction<T> Fraction<T>::operator% (const Fraction& other) const
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator% (const Fraction& other) const
 {
 	return Fraction(*this) %= other;
 }
 
 
-template <Fraction_compatible T>
-Fraction<T>& Fraction<T>::operator++ ()
+// Integer operands skip common_denominator: n/d + k is (n + k*d)/d, which
+// also stays reduced when n/d was.
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator+= (const T& other)
+{
+	TOKOX_FRACTIONS_TRACE_OPERATION(add_integer, *this, other, T(1), true);
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(Fraction(other), '+');
+	}
+	if (fits_mul<P, T>(other, _denominator) && fits_add<P, T>(_numerator, other * _denominator))
+	{
+		_numerator += other * _denominator;
+		return *this;
+	}
+	if (!reduced())
+	{
+		reduce();
+		if (fits_mul<P, T>(other, _denominator) && fits_add<P, T>(_numerator, other * _denominator))
+		{
+			_numerator += other * _denominator;
+			return *this;
+		}
+	}
+	throw FractionOverflowError<T>("Fraction::operator+=");
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator+ (const T& other) const
+{
+	return Fraction(*this) += other;
+}
+
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator-= (const T& other)
+{
+	TOKOX_FRACTIONS_TRACE_OPERATION(sub_integer, *this, other, T(1), true);
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(Fraction(other), '-');
+	}
+	if (fits_mul<P, T>(other, _denominator) && fits_sub<P, T>(_numerator, other * _denominator))
+	{
+		_numerator -= other * _denominator;
+		return *this;
+	}
+	if (!reduced())
+	{
+		reduce();
+		if (fits_mul<P, T>(other, _denominator) && fits_sub<P, T>(_numerator, other * _denominator))
+		{
+			_numerator -= other * _denominator;
+			return *this;
+		}
+	}
+	throw FractionOverflowError<T>("Fraction::operator-=");
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator- (const T& other) const
+{
+	return Fraction(*this) -= other;
+}
+
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator*= (const T& other)
+{
+	TOKOX_FRACTIONS_TRACE_OPERATION(mul_integer, *this, other, T(1), true);
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(Fraction(other), '*');
+	}
+	if (fits_mul<P, T>(_numerator, other))
+	{
+		_numerator *= other;
+		_flags &= ~REDUCED;
+		return *this;
+	}
+	reduce();
+	const T _gcd = gcd<T>(other, _denominator);
+	const T factor = other / _gcd;
+	if (fits_mul<P, T>(_numerator, factor))
+	{
+		_numerator *= factor;
+		_denominator /= _gcd;
+		return *this;
+	}
+	throw FractionOverflowError<T>("Fraction::operator*=");
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator* (const T& other) const
+{
+	return Fraction(*this) *= other;
+}
+
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator/= (const T& other)
+{
+	TOKOX_FRACTIONS_TRACE_OPERATION(div_integer, *this, other, T(1), true);
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(Fraction(other), '/');
+	}
+	if (other == T(0))
+	{
+		throw FractionDenominatorIsZeroError<T>("Fraction::operator/=");
+	}
+	if (other > T(0) && fits_mul<P, T>(_denominator, other))
+	{
+		_denominator *= other;
+		_flags &= ~REDUCED;
+		return *this;
+	}
+	reduce();
+	const T _gcd = gcd<T>(_numerator, other);
+	T n = _numerator / _gcd;
+	T factor = other / _gcd;
+	if (factor < T(0))
+	{
+		if (!fits_neg<P, T>(n) || !fits_neg<P, T>(factor))
+		{
+			throw FractionOverflowError<T>("Fraction::operator/=");
+		}
+		n = -n;
+		factor = -factor;
+	}
+	if (!fits_mul<P, T>(_denominator, factor))
+	{
+		throw FractionOverflowError<T>("Fraction::operator/=");
+	}
+	_numerator = n;
+	_denominator *= factor;
+	return *this;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator/ (const T& other) const
 {
-	if (!can_add<T>(_numerator, _denominator))
+	return Fraction(*this) /= other;
+}
+
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator%= (const T& other)
+{
+	TOKOX_FRACTIONS_TRACE_OPERATION(mod_integer, *this, other, T(1), true);
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(Fraction(other), '%');
+	}
+	if (other == T(0))
+	{
+		throw FractionDenominatorIsZeroError<T>("Fraction::operator%=");
+	}
+	if (fits_mul<P, T>(other, _denominator))
+	{
+		_numerator %= other * _denominator;
+		_flags &= ~REDUCED;
+		return *this;
+	}
+	return (*this) %= Fraction(other);
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator% (const T& other) const
+{
+	return Fraction(*this) %= other;
+}
+
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator++ ()
+{
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(Fraction(T(1)), '+');
+	}
+	if (!fits_add<P, T>(_numerator, _denominator))
 	{
 		reduce();
-		if (!can_add<T>(_numerator, _denominator))
+		if (!fits_add<P, T>(_numerator, _denominator))
 		{
 			throw FractionOverflowError<T>("Fraction::operator++");
 		}
@@ -282,8 +685,8 @@ Fraction<T>& Fraction<T>::operator++ ()
 	return *this;
 }
 
-template <Fraction_compatible T>
-Fraction<T> Fraction<T>::operator++ (int)
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator++ (int)
 {
 	Fraction copy(*this);
 	++(*this);
@@ -291,13 +694,17 @@ Fraction<T> Fraction<T>::operator++ (int)
 }
 
 
-template <Fraction_compatible T>
-Fraction<T>& Fraction<T>::operator-- ()
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::operator-- ()
 {
-	if (!can_sub<T>(_numerator, _denominator))
+	if constexpr (P != OverflowPolicy::checked)
+	{
+		return apply_policy(Fraction(T(1)), '-');
+	}
+	if (!fits_sub<P, T>(_numerator, _denominator))
 	{
 		reduce();
-		if (!can_sub<T>(_numerator, _denominator))
+		if (!fits_sub<P, T>(_numerator, _denominator))
 		{
 			throw FractionOverflowError<T>("Fraction::operator--");
 		}
@@ -306,8 +713,8 @@ Fraction<T>& Fraction<T>::operator-- ()
 	return *this;
 }
 
-template <Fraction_compatible T>
-Fraction<T> Fraction<T>::operator-- (int)
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::operator-- (int)
 {
 	Fraction copy(*this);
 	--(*this);
@@ -316,8 +723,299 @@ Fraction<T> Fraction<T>::operator-- (int)
 
 
 
-template <Fraction_compatible T>
-Fraction<T>& Fraction<T>::reduce ()
+// Henrici: with reduced a / b and c / d only gcd(b, d) and a final gcd with
+// it are needed, and the result is reduced. The try_ forms expect reduced
+// operands and leave *this unchanged when the result does not fit.
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::try_henrici (const Fraction& other, const bool subtract)
+{
+	const T g = gcd<T>(_denominator, other.denominator());
+	const T s = other.denominator() / g;
+	const T t = _denominator / g;
+	if (!fits_mul<P, T>(_numerator, s) || !fits_mul<P, T>(other.numerator(), t))
+	{
+		return false;
+	}
+	const T left = _numerator * s;
+	const T right = other.numerator() * t;
+	if (subtract ? !fits_sub<P, T>(left, right) : !fits_add<P, T>(left, right))
+	{
+		return false;
+	}
+	T n = subtract ? left - right : left + right;
+	if (n == T(0))
+	{
+		_numerator = T(0);
+		_denominator = T(1);
+		_flags |= REDUCED;
+		return true;
+	}
+	const T g2 = g == T(1) ? T(1) : gcd<T>(n, g);
+	const T b = _denominator / g2;
+	if (!fits_mul<P, T>(b, s))
+	{
+		return false;
+	}
+	_numerator = n / g2;
+	_denominator = b * s;
+	_flags |= REDUCED;
+	return true;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::henrici (const Fraction& other, const bool subtract, const char* where)
+{
+	reduce();
+	other.reduce();
+	if (!try_henrici(other, subtract))
+	{
+		throw FractionOverflowError<T>(where);
+	}
+	return *this;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::henrici_add (const Fraction& other)
+{
+	return henrici(other, false, "Fraction::henrici_add");
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::henrici_sub (const Fraction& other)
+{
+	return henrici(other, true, "Fraction::henrici_sub");
+}
+
+// Knuth: cancel gcd(a, d) and gcd(c, b) before multiplying a / b by c / d,
+// so the products are the smallest possible and the result is reduced.
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::try_knuth_mul (const Fraction& other)
+{
+	if (_numerator == T(0) || other.numerator() == T(0))
+	{
+		_numerator = T(0);
+		_denominator = T(1);
+		_flags |= REDUCED;
+		return true;
+	}
+	const T g1 = gcd<T>(_numerator, other.denominator());
+	const T g2 = gcd<T>(other.numerator(), _denominator);
+	const T n1 = _numerator / g1;
+	const T n2 = other.numerator() / g2;
+	const T d1 = _denominator / g2;
+	const T d2 = other.denominator() / g1;
+	if (!fits_mul<P, T>(n1, n2) || !fits_mul<P, T>(d1, d2))
+	{
+		return false;
+	}
+	_numerator = n1 * n2;
+	_denominator = d1 * d2;
+	_flags |= REDUCED;
+	return true;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::knuth_mul (const Fraction& other)
+{
+	reduce();
+	other.reduce();
+	if (!try_knuth_mul(other))
+	{
+		throw FractionOverflowError<T>("Fraction::knuth_mul");
+	}
+	return *this;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::knuth_div (const Fraction& other)
+{
+	return knuth_mul(other.inverted());
+}
+
+
+
+// The first attempt of common_denominator for 8 and 16 bit T: the cross
+// products are taken in int32_t and kept only if each of them fits in T, so
+// the result is the one the generic path gives, without its argument setup.
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::try_widened_add (const Fraction& other, const bool subtract) requires use_lookup_tables<T>
+{
+	const int32_t left = int32_t(_numerator) * other._denominator;
+	const int32_t right = int32_t(other._numerator) * _denominator;
+	const int32_t d = int32_t(_denominator) * other._denominator;
+	const int32_t n = subtract ? left - right : left + right;
+	if (!std::in_range<T>(left) || !std::in_range<T>(right) || !std::in_range<T>(d) || !std::in_range<T>(n))
+	{
+		return false;
+	}
+	_numerator = T(n);
+	_denominator = T(d);
+	_flags &= ~REDUCED;
+	return true;
+}
+
+// Arithmetic for every policy but checked. Saturating runs the checked
+// operation and only on overflow rounds the long double result to the closest
+// fraction that fits. A denominator that wraps to zero or to the lowest value
+// cannot be made positive and still throws.
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::apply_policy (const Fraction& other, const char op)
+{
+	if constexpr (P == OverflowPolicy::saturating)
+	{
+		try
+		{
+			Fraction<T> result(*this);
+			const Fraction<T> operand(other);
+			switch (op)
+			{
+				case '+':
+					result += operand;
+					break;
+				case '-':
+					result -= operand;
+					break;
+				case '*':
+					result *= operand;
+					break;
+				case '/':
+					result /= operand;
+					break;
+				default:
+					result %= operand;
+			}
+			*this = Fraction(result);
+		}
+		catch (FractionOverflowError<T>&)
+		{
+			const long double a = approximate();
+			const long double b = other.approximate();
+			switch (op)
+			{
+				case '+':
+					*this = saturate(a + b);
+					break;
+				case '-':
+					*this = saturate(a - b);
+					break;
+				case '*':
+					*this = saturate(a * b);
+					break;
+				case '/':
+					*this = saturate(a / b);
+					break;
+				default:
+					*this = saturate(std::fmod(a, b));
+			}
+		}
+		return *this;
+	}
+	else
+	{
+		if constexpr (P == OverflowPolicy::wrapping)
+		{
+			reduce();
+			other.reduce();
+		}
+		T n, d;
+		switch (op)
+		{
+			case '+':
+				n = raw_add<P, T>(raw_mul<P, T>(_numerator, other._denominator), raw_mul<P, T>(other._numerator, _denominator));
+				d = raw_mul<P, T>(_denominator, other._denominator);
+				break;
+			case '-':
+				n = raw_sub<P, T>(raw_mul<P, T>(_numerator, other._denominator), raw_mul<P, T>(other._numerator, _denominator));
+				d = raw_mul<P, T>(_denominator, other._denominator);
+				break;
+			case '*':
+				n = raw_mul<P, T>(_numerator, other._numerator);
+				d = raw_mul<P, T>(_denominator, other._denominator);
+				break;
+			case '/':
+				if (other._numerator == T(0))
+				{
+					throw FractionDenominatorIsZeroError<T>("Fraction::operator/=");
+				}
+				n = raw_mul<P, T>(_numerator, other._denominator);
+				d = raw_mul<P, T>(_denominator, other._numerator);
+				break;
+			default:
+			{
+				const T m = raw_mul<P, T>(other._numerator, _denominator);
+				if (m == T(0))
+				{
+					throw FractionDenominatorIsZeroError<T>("Fraction::operator%=");
+				}
+				n = m == T(-1) ? T(0) : raw_mul<P, T>(_numerator, other._denominator) % m;
+				d = raw_mul<P, T>(_denominator, other._denominator);
+			}
+		}
+		if (d < T(0))
+		{
+			n = raw_neg<P, T>(n);
+			d = raw_neg<P, T>(d);
+		}
+		if (d <= T(0))
+		{
+			throw FractionOverflowError<T>(std::string("Fraction::operator") + op + "=");
+		}
+		_numerator = n;
+		_denominator = d;
+		_flags &= ~REDUCED;
+		return *this;
+	}
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+long double Fraction<T, P>::approximate () const
+{
+	return static_cast<long double>(_numerator) / static_cast<long double>(_denominator);
+}
+
+// Out of range values clamp to the largest or lowest integer; in range ones
+// take the last continued fraction convergent whose terms still fit in T.
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::saturate (const long double x)
+{
+	const long double limit = std::ldexp(1.0L, std::numeric_limits<T>::digits);
+	if (x >= limit)
+	{
+		return Fraction(std::numeric_limits<T>::max());
+	}
+	if (x <= -limit)
+	{
+		return Fraction(std::numeric_limits<T>::lowest());
+	}
+	long double rest = std::fabs(x);
+	long double p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+	while (true)
+	{
+		const long double a = std::floor(rest);
+		const long double p2 = a * p1 + p0;
+		const long double q2 = a * q1 + q0;
+		if (p2 >= limit || q2 >= limit)
+		{
+			break;
+		}
+		p0 = p1;
+		q0 = q1;
+		p1 = p2;
+		q1 = q2;
+		if (rest == a)
+		{
+			break;
+		}
+		rest = 1 / (rest - a);
+	}
+	const T n = static_cast<T>(p1);
+	return Fraction(x < 0 ? -n : n, static_cast<T>(q1), REDUCED);
+}
+
+
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::reduce ()
 {
 	if (!reduced())
 	{
@@ -329,8 +1027,8 @@ Fraction<T>& Fraction<T>::reduce ()
 	return *this;
 }
 
-template <Fraction_compatible T>
-const Fraction<T>& Fraction<T>::reduce () const
+template <Fraction_compatible T, OverflowPolicy P>
+const Fraction<T, P>& Fraction<T, P>::reduce () const
 {
 	if (!reduced())
 	{
@@ -342,15 +1040,15 @@ const Fraction<T>& Fraction<T>::reduce () const
 	return *this;
 }
 
-template <Fraction_compatible T>
-bool Fraction<T>::reduced () const
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::reduced () const
 {
 	return _flags & REDUCED;
 }
 
 
-template <Fraction_compatible T>
-Fraction<T>& Fraction<T>::invert ()
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P>& Fraction<T, P>::invert ()
 {
 	T tmp = _numerator;
 	_numerator = _denominator;
@@ -368,83 +1066,258 @@ Fraction<T>& Fraction<T>::invert ()
 	return (*this);
 }
 
-template <Fraction_compatible T>
-Fraction<T> Fraction<T>::inverted () const
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::inverted () const
 {
 	return Fraction(*this).invert();
 }
 
 
+// Best rational approximation with denominator at most max_denominator, found
+// from the continued fraction expansion as in Python's
+// Fraction.limit_denominator. The last convergent and the last semiconvergent
+// lie on opposite sides of the value, so directed rounding picks one of them.
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> Fraction<T, P>::limit_denominator (const T max_denominator, const Rounding r) const
+{
+	if (max_denominator < T(1))
+	{
+		throw std::invalid_argument("max_denominator < 1 in tokox::Fraction::limit_denominator");
+	}
+	reduce();
+	if (_denominator <= max_denominator)
+	{
+		return Fraction(*this);
+	}
+	const bool negative = _numerator < T(0);
+	if (negative && !fits_neg<P, T>(_numerator))
+	{
+		throw FractionOverflowError<T>("Fraction::limit_denominator");
+	}
+	T n = negative ? -_numerator : _numerator;
+	T d = _denominator;
+	T p0 = T(0), q0 = T(1), p1 = T(1), q1 = T(0);
+	bool convergent_below = false;
+	while (true)
+	{
+		const T a = n / d;
+		const T q2 = q0 + a * q1;
+		if (q2 > max_denominator)
+		{
+			break;
+		}
+		const T p2 = p0 + a * p1;
+		p0 = p1;
+		q0 = q1;
+		p1 = p2;
+		q1 = q2;
+		const T rem = n - a * d;
+		n = d;
+		d = rem;
+		convergent_below = !convergent_below;
+	}
+	const T k = (max_denominator - q0) / q1;
+	const Fraction semiconvergent(p0 + k * p1, q0 + k * q1);
+	const Fraction convergent(p1, q1);
+	bool take_convergent;
+	switch (r)
+	{
+		case Rounding::to_nearest:
+			take_convergent = compare_positive<T>(q0 + k * q1, q1, n - k * d, d) <= 0;
+			break;
+		case Rounding::toward_zero:
+			take_convergent = convergent_below;
+			break;
+		case Rounding::toward_neg_infinity:
+			take_convergent = convergent_below != negative;
+			break;
+		case Rounding::toward_infinity:
+			take_convergent = convergent_below == negative;
+			break;
+		default:
+			throw std::invalid_argument("unknown rounding in tokox::Fraction::limit_denominator");
+	}
+	Fraction result(take_convergent ? convergent : semiconvergent);
+	result._flags |= REDUCED;
+	return negative ? -result : result;
+}
 
-template <Fraction_compatible T>
-bool Fraction<T>::operator== (const Fraction& other) const
+
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator== (const Fraction& other) const
 {
 	return (*this) <= other && (*this) >= other;
 }
 
-template <Fraction_compatible T>
-bool Fraction<T>::operator!= (const Fraction& other) const
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator!= (const Fraction& other) const
 {
 	return !((*this) == other);
 }
 
 
-template <Fraction_compatible T>
-bool Fraction<T>::operator< (const Fraction& other) const
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator< (const Fraction& other) const
 {
+	TOKOX_FRACTIONS_TRACE_OPERATION(less, *this, other.numerator(), other.denominator(), other.reduced());
+	if constexpr (use_lookup_tables<T>)
+	{
+		const int32_t left = int32_t(_numerator) * other._denominator;
+		const int32_t right = int32_t(other._numerator) * _denominator;
+		if (std::in_range<T>(left) && std::in_range<T>(right) && std::in_range<T>(int32_t(_denominator) * other._denominator))
+		{
+			return left < right;
+		}
+	}
 	T common_denom = common_denominator(*this, other);
 	return (_numerator * (common_denom / _denominator)) < (other.numerator() * (common_denom / other.denominator()));
 }
 
-template <Fraction_compatible T>
-bool Fraction<T>::operator> (const Fraction& other) const
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator> (const Fraction& other) const
 {
 	return other < (*this);
 }
 
-template <Fraction_compatible T>
-bool Fraction<T>::operator<= (const Fraction& other) const
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator<= (const Fraction& other) const
 {
 	return !((*this) > other);
 }
 
-template <Fraction_compatible T>
-bool Fraction<T>::operator>= (const Fraction& other) const
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator>= (const Fraction& other) const
 {
 	return !((*this) < other);
 }
 
 
 
-template <Fraction_compatible T>
-T Fraction<T>::value () const
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator== (const T& other) const
+{
+	return compare(other) == 0;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator!= (const T& other) const
+{
+	return compare(other) != 0;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator> (const T& other) const
+{
+	return compare(other) > 0;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator>= (const T& other) const
+{
+	return compare(other) >= 0;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator< (const T& other) const
+{
+	return compare(other) < 0;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool Fraction<T, P>::operator<= (const T& other) const
+{
+	return compare(other) <= 0;
+}
+
+// n/d against k is one multiplication; when k*d overflows the floor of n/d
+// decides without any multiplication.
+template <Fraction_compatible T, OverflowPolicy P>
+int Fraction<T, P>::compare (const T& other) const
+{
+	TOKOX_FRACTIONS_TRACE_OPERATION(compare_integer, *this, other, T(1), true);
+	if constexpr (use_lookup_tables<T>)
+	{
+		const int32_t scaled = int32_t(other) * _denominator;
+		return _numerator < scaled ? -1 : (scaled < _numerator ? 1 : 0);
+	}
+	if (fits_mul<P, T>(other, _denominator))
+	{
+		const T scaled = other * _denominator;
+		return _numerator < scaled ? -1 : (scaled < _numerator ? 1 : 0);
+	}
+	const T floor = value(Rounding::toward_neg_infinity);
+	if (floor != other)
+	{
+		return floor < other ? -1 : 1;
+	}
+	return _numerator % _denominator == T(0) ? 0 : 1;
+}
+
+
+
+template <Fraction_compatible T, OverflowPolicy P>
+T Fraction<T, P>::value () const
 {
 	return _numerator / _denominator;
 }
 
+template <Fraction_compatible T, OverflowPolicy P>
+T Fraction<T, P>::value (const Rounding r) const
+{
+	const T q = _numerator / _denominator;
+	const T rem = _numerator % _denominator;
+	if (rem == T(0))
+	{
+		return q;
+	}
+	const T away = _numerator < T(0) ? q - T(1) : q + T(1);
+	switch (r)
+	{
+		case Rounding::to_nearest:
+		{
+			const T abs_rem = rem < T(0) ? -rem : rem;
+			const T rest = _denominator - abs_rem;
+			if (abs_rem != rest)
+			{
+				return abs_rem < rest ? q : away;
+			}
+			return q % T(2) == T(0) ? q : away;
+		}
+		case Rounding::toward_zero:
+			return q;
+		case Rounding::toward_neg_infinity:
+			return _numerator < T(0) ? away : q;
+		case Rounding::toward_infinity:
+			return _numerator < T(0) ? q : away;
+		default:
+			throw std::invalid_argument("unknown rounding in tokox::Fraction::value");
+	}
+}
 
-template <Fraction_compatible T>
-T Fraction<T>::numerator () const
+
+template <Fraction_compatible T, OverflowPolicy P>
+T Fraction<T, P>::numerator () const
 {
 	return _numerator;
 }
 
-template <Fraction_compatible T>
-void Fraction<T>::numerator (const T n)
+template <Fraction_compatible T, OverflowPolicy P>
+void Fraction<T, P>::numerator (const T n)
 {
 	_numerator = n;
 	_flags &= ~REDUCED;
 }
 
 
-template <Fraction_compatible T>
-T Fraction<T>::denominator () const
+template <Fraction_compatible T, OverflowPolicy P>
+T Fraction<T, P>::denominator () const
 {
 	return _denominator;
 }
 
-template <Fraction_compatible T>
-void Fraction<T>::denominator (const T d)
+template <Fraction_compatible T, OverflowPolicy P>
+void Fraction<T, P>::denominator (const T d)
 {
 	_denominator = d;
 	_flags &= ~REDUCED;
@@ -460,20 +1333,172 @@ void Fraction<T>::denominator (const T d)
 }
 
 
-template <Fraction_compatible T>
-void Fraction<T>::swap (Fraction<T>& other)
+template <Fraction_compatible T, OverflowPolicy P>
+void Fraction<T, P>::swap (Fraction<T, P>& other)
 {
-	const Fraction<T> other_copy(other);
+	const Fraction<T, P> other_copy(other);
 	other = *this;
 	*this = other_copy;
 }
 
 
-template <Fraction_compatible T>
-std::size_t Fraction<T>::hash () const requires Hashable<T>
+template <Fraction_compatible T, OverflowPolicy P>
+std::size_t Fraction<T, P>::hash () const requires Hashable<T>
 {
 	reduce();
 	return (7 * std::hash<T>()(_numerator)) + (((((size_t) 257) << 32) + 1023) * std::hash<T>()(_denominator));
 }
 
+
+
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> operator+ (const std::type_identity_t<T>& a, const Fraction<T, P>& b)
+{
+	return b + a;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> operator- (const std::type_identity_t<T>& a, const Fraction<T, P>& b)
+{
+	return (-b) += a;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> operator* (const std::type_identity_t<T>& a, const Fraction<T, P>& b)
+{
+	return b * a;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> operator/ (const std::type_identity_t<T>& a, const Fraction<T, P>& b)
+{
+	return b.inverted() *= a;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> operator% (const std::type_identity_t<T>& a, const Fraction<T, P>& b)
+{
+	return Fraction<T, P>(a) %= b;
+}
+
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator== (const std::type_identity_t<T>& a, const Fraction<T, P>& b)
+{
+	return b == a;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator!= (const std::type_identity_t<T>& a, const Fraction<T, P>& b)
+{
+	return b != a;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator> (const std::type_identity_t<T>& a, const Fraction<T, P>& b)
+{
+	return b < a;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator>= (const std::type_identity_t<T>& a, const Fraction<T, P>& b)
+{
+	return b <= a;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator< (const std::type_identity_t<T>& a, const Fraction<T, P>& b)
+{
+	return b > a;
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator<= (const std::type_identity_t<T>& a, const Fraction<T, P>& b)
+{
+	return b >= a;
+}
+
+
+
+// Mixed widths are widened without reducing: the conversion keeps numerator,
+// denominator and the reduced flag as they are.
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+Fraction<wider_t<T, U>, P> operator+ (const Fraction<T, P>& a, const Fraction<U, P>& b)
+{
+	return Fraction<wider_t<T, U>, P>(a) += Fraction<wider_t<T, U>, P>(b);
+}
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+Fraction<wider_t<T, U>, P> operator- (const Fraction<T, P>& a, const Fraction<U, P>& b)
+{
+	return Fraction<wider_t<T, U>, P>(a) -= Fraction<wider_t<T, U>, P>(b);
+}
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+Fraction<wider_t<T, U>, P> operator* (const Fraction<T, P>& a, const Fraction<U, P>& b)
+{
+	return Fraction<wider_t<T, U>, P>(a) *= Fraction<wider_t<T, U>, P>(b);
+}
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+Fraction<wider_t<T, U>, P> operator/ (const Fraction<T, P>& a, const Fraction<U, P>& b)
+{
+	return Fraction<wider_t<T, U>, P>(a) /= Fraction<wider_t<T, U>, P>(b);
+}
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+Fraction<wider_t<T, U>, P> operator% (const Fraction<T, P>& a, const Fraction<U, P>& b)
+{
+	return Fraction<wider_t<T, U>, P>(a) %= Fraction<wider_t<T, U>, P>(b);
+}
+
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator== (const Fraction<T, P>& a, const Fraction<U, P>& b)
+{
+	return Fraction<wider_t<T, U>, P>(a) == Fraction<wider_t<T, U>, P>(b);
+}
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator!= (const Fraction<T, P>& a, const Fraction<U, P>& b)
+{
+	return Fraction<wider_t<T, U>, P>(a) != Fraction<wider_t<T, U>, P>(b);
+}
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator> (const Fraction<T, P>& a, const Fraction<U, P>& b)
+{
+	return Fraction<wider_t<T, U>, P>(a) > Fraction<wider_t<T, U>, P>(b);
+}
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator>= (const Fraction<T, P>& a, const Fraction<U, P>& b)
+{
+	return Fraction<wider_t<T, U>, P>(a) >= Fraction<wider_t<T, U>, P>(b);
+}
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator< (const Fraction<T, P>& a, const Fraction<U, P>& b)
+{
+	return Fraction<wider_t<T, U>, P>(a) < Fraction<wider_t<T, U>, P>(b);
+}
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator<= (const Fraction<T, P>& a, const Fraction<U, P>& b)
+{
+	return Fraction<wider_t<T, U>, P>(a) <= Fraction<wider_t<T, U>, P>(b);
+}
+
 }
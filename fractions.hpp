@@ -1,15 +1,43 @@
 #ifndef TOKOX_FRACTIONS
 #define TOKOX_FRACTIONS
 
+// The prebuilt instantiations behind TOKOX_FRACTIONS_EXTERN_TEMPLATES have one
+// set of member bodies, so a switch that changes them would silently lose to
+// the library's variant (and break the one definition rule).
+#if defined(TOKOX_FRACTIONS_EXTERN_TEMPLATES) && defined(TOKOX_FRACTIONS_TRACE)
+#error "TOKOX_FRACTIONS_TRACE cannot be combined with TOKOX_FRACTIONS_EXTERN_TEMPLATES"
+#endif
+#if defined(TOKOX_FRACTIONS_EXTERN_TEMPLATES) && defined(TOKOX_FRACTIONS_CROSS_CANCELLATION)
+#error "TOKOX_FRACTIONS_CROSS_CANCELLATION cannot be combined with TOKOX_FRACTIONS_EXTERN_TEMPLATES"
+#endif
+#if defined(TOKOX_FRACTIONS_EXTERN_TEMPLATES) && defined(TOKOX_FRACTIONS_LOOKUP_TABLE_BUDGET)
+#error "TOKOX_FRACTIONS_LOOKUP_TABLE_BUDGET cannot be combined with TOKOX_FRACTIONS_EXTERN_TEMPLATES"
+#endif
+
 #include <cstddef>
 #include <limits>
 #include <functional>
 #include <concepts>
 #include <stdexcept>
 #include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+#include <cmath>
 
 #include "numeric_helper_functions.hpp"
 
+// With TOKOX_FRACTIONS_TRACE defined the arithmetic and comparison operators
+// can record their operands with tokox::trace::start(); see tracing.hpp.
+#ifdef TOKOX_FRACTIONS_TRACE
+#include "tracing.hpp"
+#define TOKOX_FRACTIONS_TRACE_OPERATION(OP, A, BN, BD, BR) \
+	const trace::Scope trace_scope(trace::Operation::OP, static_cast<uint8_t>(P), \
+		(A).numerator(), (A).denominator(), (A).reduced(), BN, BD, BR)
+#else
+#define TOKOX_FRACTIONS_TRACE_OPERATION(OP, A, BN, BD, BR)
+#endif
+
 namespace tokox
 {
 
@@ -68,14 +96,59 @@ public:
 	{}
 };
 
-template <Fraction_compatible T = int>
+template<typename T = void>
+class FractionInexactError : public std::domain_error
+{
+public:
+	FractionInexactError (const std::string& what):
+		std::domain_error("inexact conversion of tokox::Fraction"
+			+ (typeid(T) == typeid(void) ? "" : "<" + get_typename<T>() + ">")
+			+ " in " + what)
+	{}
+};
+
+enum class Rounding
+{
+	to_nearest,
+	toward_zero,
+	toward_neg_infinity,
+	toward_infinity
+};
+
+// checked throws FractionOverflowError, unchecked trusts the caller and only
+// asserts, wrapping keeps numerator and denominator modulo 2^N and saturating
+// falls back to the closest representable value. The last two need a builtin T.
+enum class OverflowPolicy
+{
+	checked,
+	unchecked,
+	wrapping,
+	saturating
+};
+
+template <Fraction_compatible T, Fraction_compatible U>
+using wider_t = std::conditional_t<!std::numeric_limits<T>::is_bounded
+	|| (std::numeric_limits<U>::is_bounded && std::numeric_limits<T>::digits >= std::numeric_limits<U>::digits), T, U>;
+
+template <Fraction_compatible T = int, OverflowPolicy P = OverflowPolicy::checked>
 class Fraction
 {
+	static_assert(P == OverflowPolicy::checked || P == OverflowPolicy::unchecked || std::integral<T>,
+		"wrapping and saturating tokox::Fraction need a builtin integer type");
+
 public:
 	Fraction (const T n = T(0), const T d = T(1));
 
 	Fraction (const Fraction& other);
 
+	template <Fraction_compatible U, OverflowPolicy Q>
+		requires ((!std::same_as<T, U> || P != Q) && std::constructible_from<T, U> && std::constructible_from<U, T>)
+	explicit(!std::same_as<wider_t<T, U>, T> || P != Q) Fraction (const Fraction<U, Q>& other);
+
+	// For n / d already in lowest terms with d > 0, which is taken as it is
+	// and flagged so that it is never reduced again.
+	static Fraction from_reduced (const T n, const T d);
+
 
 	Fraction& operator= (const Fraction& other);
 
@@ -96,12 +169,37 @@ public:
 	Fraction& operator%= (const Fraction& other);
 	Fraction operator% (const Fraction& other) const;
 
+	Fraction& operator+= (const T& other);
+	Fraction operator+ (const T& other) const;
+
+	Fraction& operator-= (const T& other);
+	Fraction operator- (const T& other) const;
+
+	Fraction& operator*= (const T& other);
+	Fraction operator* (const T& other) const;
+
+	Fraction& operator/= (const T& other);
+	Fraction operator/ (const T& other) const;
+
+	Fraction& operator%= (const T& other);
+	Fraction operator% (const T& other) const;
+
 	Fraction& operator++ ();
 	Fraction operator++ (int);
 
 	Fraction& operator-- ();
 	Fraction operator-- (int);
 
+	Fraction& henrici_add (const Fraction& other);
+	Fraction& henrici_sub (const Fraction& other);
+	Fraction& knuth_mul (const Fraction& other);
+	Fraction& knuth_div (const Fraction& other);
+
+	// The cores of henrici_add / henrici_sub and knuth_mul for reduced
+	// operands: false, with *this unchanged, instead of an overflow.
+	bool try_henrici (const Fraction& other, const bool subtract);
+	bool try_knuth_mul (const Fraction& other);
+
 
 	Fraction& reduce ();
 	const Fraction& reduce () const;
@@ -110,6 +208,8 @@ public:
 	Fraction& invert ();
 	Fraction inverted () const;
 
+	Fraction limit_denominator (const T max_denominator, const Rounding r = Rounding::to_nearest) const;
+
 
 	bool operator== (const Fraction& other) const;
 	bool operator!= (const Fraction& other) const;
@@ -120,8 +220,18 @@ public:
 	bool operator< (const Fraction& other) const;
 	bool operator<= (const Fraction& other) const;
 
+	bool operator== (const T& other) const;
+	bool operator!= (const T& other) const;
+
+	bool operator> (const T& other) const;
+	bool operator>= (const T& other) const;
+
+	bool operator< (const T& other) const;
+	bool operator<= (const T& other) const;
+
 
 	T value () const;
+	T value (const Rounding r) const;
 
 	T numerator () const;
 	void numerator (const T n);
@@ -136,6 +246,12 @@ public:
 
 private:
 	Fraction(const T n, const T d, const uint8_t flags);
+	Fraction& henrici (const Fraction& other, const bool subtract, const char* where);
+	bool try_widened_add (const Fraction& other, const bool subtract) requires use_lookup_tables<T>;
+	int compare (const T& other) const;
+	Fraction& apply_policy (const Fraction& other, const char op);
+	long double approximate () const;
+	static Fraction saturate (const long double x);
 	mutable T _numerator;
 	mutable T _denominator;
 	mutable uint8_t _flags;
@@ -145,10 +261,101 @@ private:
 	};
 };
 
-template class Fraction<int>;
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> operator+ (const std::type_identity_t<T>& a, const Fraction<T, P>& b);
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> operator- (const std::type_identity_t<T>& a, const Fraction<T, P>& b);
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> operator* (const std::type_identity_t<T>& a, const Fraction<T, P>& b);
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> operator/ (const std::type_identity_t<T>& a, const Fraction<T, P>& b);
+template <Fraction_compatible T, OverflowPolicy P>
+Fraction<T, P> operator% (const std::type_identity_t<T>& a, const Fraction<T, P>& b);
+
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator== (const std::type_identity_t<T>& a, const Fraction<T, P>& b);
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator!= (const std::type_identity_t<T>& a, const Fraction<T, P>& b);
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator> (const std::type_identity_t<T>& a, const Fraction<T, P>& b);
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator>= (const std::type_identity_t<T>& a, const Fraction<T, P>& b);
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator< (const std::type_identity_t<T>& a, const Fraction<T, P>& b);
+template <Fraction_compatible T, OverflowPolicy P>
+bool operator<= (const std::type_identity_t<T>& a, const Fraction<T, P>& b);
+
+template <typename T, typename U>
+concept Fraction_mixable = !std::same_as<T, U>
+	&& std::constructible_from<Fraction<wider_t<T, U>>, Fraction<T>>
+	&& std::constructible_from<Fraction<wider_t<T, U>>, Fraction<U>>;
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+Fraction<wider_t<T, U>, P> operator+ (const Fraction<T, P>& a, const Fraction<U, P>& b);
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+Fraction<wider_t<T, U>, P> operator- (const Fraction<T, P>& a, const Fraction<U, P>& b);
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+Fraction<wider_t<T, U>, P> operator* (const Fraction<T, P>& a, const Fraction<U, P>& b);
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+Fraction<wider_t<T, U>, P> operator/ (const Fraction<T, P>& a, const Fraction<U, P>& b);
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+Fraction<wider_t<T, U>, P> operator% (const Fraction<T, P>& a, const Fraction<U, P>& b);
+
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator== (const Fraction<T, P>& a, const Fraction<U, P>& b);
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator!= (const Fraction<T, P>& a, const Fraction<U, P>& b);
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator> (const Fraction<T, P>& a, const Fraction<U, P>& b);
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator>= (const Fraction<T, P>& a, const Fraction<U, P>& b);
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator< (const Fraction<T, P>& a, const Fraction<U, P>& b);
+template <Fraction_compatible T, Fraction_compatible U, OverflowPolicy P>
+	requires Fraction_mixable<T, U>
+bool operator<= (const Fraction<T, P>& a, const Fraction<U, P>& b);
 
 }
 
 #include "fractions.cpp"
 
+#define TOKOX_FRACTIONS_INSTANTIATE(EXTERN, T) \
+	EXTERN template class Fraction<T>; \
+	EXTERN template T common_denominator<T> (const Fraction<T>&, const Fraction<T>&, std::string, std::function<bool(T, T)>); \
+	EXTERN template int compare_positive<T> (T, T, T, T); \
+	EXTERN template T gcd<T> (const T&, const T&); \
+	EXTERN template T lcm<T> (const T&, const T&);
+
+#if defined(__SIZEOF_INT128__) && !defined(__STRICT_ANSI__)
+#define TOKOX_FRACTIONS_INSTANTIATE_INT128(EXTERN) TOKOX_FRACTIONS_INSTANTIATE(EXTERN, __int128)
+#else
+#define TOKOX_FRACTIONS_INSTANTIATE_INT128(EXTERN)
+#endif
+
+#define TOKOX_FRACTIONS_INSTANTIATE_ALL(EXTERN) \
+	TOKOX_FRACTIONS_INSTANTIATE(EXTERN, int8_t) \
+	TOKOX_FRACTIONS_INSTANTIATE(EXTERN, int16_t) \
+	TOKOX_FRACTIONS_INSTANTIATE(EXTERN, int32_t) \
+	TOKOX_FRACTIONS_INSTANTIATE(EXTERN, int64_t) \
+	TOKOX_FRACTIONS_INSTANTIATE_INT128(EXTERN)
+
+// With TOKOX_FRACTIONS_EXTERN_TEMPLATES defined the common integer types are
+// not instantiated in every translation unit; link tokox_fractions.cpp instead.
+#ifdef TOKOX_FRACTIONS_EXTERN_TEMPLATES
+namespace tokox
+{
+TOKOX_FRACTIONS_INSTANTIATE_ALL(extern)
+}
+#endif
+
 #endif
@@ -0,0 +1,546 @@
+#include "linalg.hpp"
+namespace tokox::linalg
+{
+
+template <Fraction_compatible T>
+Matrix<T>::Matrix (const std::size_t rows, const std::size_t cols):
+	_rows(rows),
+	_cols(cols),
+	_data(rows * cols)
+{}
+
+template <Fraction_compatible T>
+Matrix<T>::Matrix (std::initializer_list<std::initializer_list<Fraction<T>>> rows):
+	_rows(rows.size()),
+	_cols(rows.size() == 0 ? 0 : rows.begin()->size()),
+	_data()
+{
+	_data.reserve(_rows * _cols);
+	for (const auto& r : rows)
+	{
+		if (r.size() != _cols)
+		{
+			throw std::invalid_argument("rows of different length in tokox::linalg::Matrix::Matrix");
+		}
+		_data.insert(_data.end(), r.begin(), r.end());
+	}
+}
+
+template <Fraction_compatible T>
+Matrix<T> Matrix<T>::identity (const std::size_t n)
+{
+	Matrix result(n, n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		result(i, i) = Fraction<T>(1);
+	}
+	return result;
+}
+
+
+
+template <Fraction_compatible T>
+Fraction<T>& Matrix<T>::operator() (const std::size_t r, const std::size_t c)
+{
+	return _data[r * _cols + c];
+}
+
+template <Fraction_compatible T>
+const Fraction<T>& Matrix<T>::operator() (const std::size_t r, const std::size_t c) const
+{
+	return _data[r * _cols + c];
+}
+
+template <Fraction_compatible T>
+Fraction<T>* Matrix<T>::row (const std::size_t r)
+{
+	return _data.data() + r * _cols;
+}
+
+template <Fraction_compatible T>
+const Fraction<T>* Matrix<T>::row (const std::size_t r) const
+{
+	return _data.data() + r * _cols;
+}
+
+template <Fraction_compatible T>
+std::size_t Matrix<T>::rows () const
+{
+	return _rows;
+}
+
+template <Fraction_compatible T>
+std::size_t Matrix<T>::cols () const
+{
+	return _cols;
+}
+
+
+
+template <Fraction_compatible T>
+Matrix<T>& Matrix<T>::operator+= (const Matrix& other)
+{
+	if (_rows != other._rows || _cols != other._cols)
+	{
+		throw std::invalid_argument("dimension mismatch in tokox::linalg::Matrix::operator+=");
+	}
+	for (std::size_t i = 0; i < _data.size(); ++i)
+	{
+		_data[i] += other._data[i];
+	}
+	return *this;
+}
+
+template <Fraction_compatible T>
+Matrix<T> Matrix<T>::operator+ (const Matrix& other) const
+{
+	return Matrix(*this) += other;
+}
+
+
+template <Fraction_compatible T>
+Matrix<T>& Matrix<T>::operator-= (const Matrix& other)
+{
+	if (_rows != other._rows || _cols != other._cols)
+	{
+		throw std::invalid_argument("dimension mismatch in tokox::linalg::Matrix::operator-=");
+	}
+	for (std::size_t i = 0; i < _data.size(); ++i)
+	{
+		_data[i] -= other._data[i];
+	}
+	return *this;
+}
+
+template <Fraction_compatible T>
+Matrix<T> Matrix<T>::operator- (const Matrix& other) const
+{
+	return Matrix(*this) -= other;
+}
+
+
+template <Fraction_compatible T>
+Matrix<T> Matrix<T>::operator* (const Matrix& other) const
+{
+	if (_cols != other._rows)
+	{
+		throw std::invalid_argument("dimension mismatch in tokox::linalg::Matrix::operator*");
+	}
+	Matrix result(_rows, other._cols);
+	for (std::size_t ii = 0; ii < _rows; ii += block_size)
+	{
+		const std::size_t i_end = std::min(ii + block_size, _rows);
+		for (std::size_t kk = 0; kk < _cols; kk += block_size)
+		{
+			const std::size_t k_end = std::min(kk + block_size, _cols);
+			for (std::size_t jj = 0; jj < other._cols; jj += block_size)
+			{
+				const std::size_t j_end = std::min(jj + block_size, other._cols);
+				for (std::size_t i = ii; i < i_end; ++i)
+				{
+					Fraction<T>* result_row = result.row(i);
+					for (std::size_t k = kk; k < k_end; ++k)
+					{
+						const Fraction<T>& a = (*this)(i, k);
+						if (a.numerator() == T(0))
+						{
+							continue;
+						}
+						const Fraction<T>* other_row = other.row(k);
+						for (std::size_t j = jj; j < j_end; ++j)
+						{
+							result_row[j] += a * other_row[j];
+						}
+					}
+				}
+			}
+		}
+	}
+	return result;
+}
+
+template <Fraction_compatible T>
+std::vector<Fraction<T>> Matrix<T>::operator* (const std::vector<Fraction<T>>& v) const
+{
+	if (_cols != v.size())
+	{
+		throw std::invalid_argument("dimension mismatch in tokox::linalg::Matrix::operator*");
+	}
+	std::vector<Fraction<T>> result(_rows);
+	for (std::size_t i = 0; i < _rows; ++i)
+	{
+		const Fraction<T>* r = row(i);
+		for (std::size_t j = 0; j < _cols; ++j)
+		{
+			result[i] += r[j] * v[j];
+		}
+	}
+	return result;
+}
+
+
+template <Fraction_compatible T>
+bool Matrix<T>::operator== (const Matrix& other) const
+{
+	return _rows == other._rows && _cols == other._cols && _data == other._data;
+}
+
+template <Fraction_compatible T>
+bool Matrix<T>::operator!= (const Matrix& other) const
+{
+	return !((*this) == other);
+}
+
+
+template <Fraction_compatible T>
+Matrix<T> Matrix<T>::transposed () const
+{
+	Matrix result(_cols, _rows);
+	for (std::size_t ii = 0; ii < _rows; ii += block_size)
+	{
+		const std::size_t i_end = std::min(ii + block_size, _rows);
+		for (std::size_t jj = 0; jj < _cols; jj += block_size)
+		{
+			const std::size_t j_end = std::min(jj + block_size, _cols);
+			for (std::size_t i = ii; i < i_end; ++i)
+			{
+				for (std::size_t j = jj; j < j_end; ++j)
+				{
+					result(j, i) = (*this)(i, j);
+				}
+			}
+		}
+	}
+	return result;
+}
+
+
+
+namespace detail
+{
+
+template <Fraction_compatible T>
+struct IntegerMatrix
+{
+	std::size_t rows;
+	std::size_t cols;
+	std::vector<T> data;
+
+	T* row (const std::size_t r)
+	{
+		return data.data() + r * cols;
+	}
+};
+
+struct Echelon
+{
+	std::size_t rank;
+	bool negated;
+	std::vector<std::size_t> pivots;
+};
+
+// Every row of [a | b] is multiplied by the lcm of its denominators, which
+// leaves the solutions unchanged and scales the determinant by scales[i].
+template <Fraction_compatible T>
+IntegerMatrix<T> integer_form (const Matrix<T>& a, const Matrix<T>& b, std::vector<T>& scales)
+{
+	IntegerMatrix<T> m{a.rows(), a.cols() + b.cols(), std::vector<T>(a.rows() * (a.cols() + b.cols()), T(0))};
+	scales.assign(a.rows(), T(1));
+	for (std::size_t i = 0; i < a.rows(); ++i)
+	{
+		T scale = T(1);
+		try
+		{
+			for (std::size_t j = 0; j < a.cols(); ++j)
+			{
+				scale = lcm<T>(scale, a(i, j).reduce().denominator());
+			}
+			for (std::size_t j = 0; j < b.cols(); ++j)
+			{
+				scale = lcm<T>(scale, b(i, j).reduce().denominator());
+			}
+		}
+		catch (std::overflow_error&)
+		{
+			throw FractionOverflowError<T>("linalg::integer_form");
+		}
+		T* r = m.row(i);
+		for (std::size_t j = 0; j < m.cols; ++j)
+		{
+			const Fraction<T>& f = j < a.cols() ? a(i, j) : b(i, j - a.cols());
+			const T factor = scale / f.denominator();
+			if (!can_mul<T>(f.numerator(), factor))
+			{
+				throw FractionOverflowError<T>("linalg::integer_form");
+			}
+			r[j] = f.numerator() * factor;
+		}
+		scales[i] = scale;
+	}
+	return m;
+}
+
+template <Fraction_compatible T>
+std::size_t find_pivot (IntegerMatrix<T>& m, const std::size_t r, const std::size_t c, const std::size_t elim_cols, bool& negated)
+{
+	for (std::size_t col = c; col < elim_cols; ++col)
+	{
+		for (std::size_t p = r; p < m.rows; ++p)
+		{
+			if (m.row(p)[col] != T(0))
+			{
+				if (p != r)
+				{
+					std::swap_ranges(m.row(p), m.row(p) + m.cols, m.row(r));
+					negated = !negated;
+				}
+				return col;
+			}
+		}
+	}
+	return elim_cols;
+}
+
+// One Bareiss step for row i: the division by the previous pivot is exact.
+template <Fraction_compatible T>
+void eliminate_row (IntegerMatrix<T>& m, const std::size_t r, const std::size_t c, const std::size_t i, const T& prev)
+{
+	T* pivot_row = m.row(r);
+	T* current_row = m.row(i);
+	const T pivot = pivot_row[c];
+	const T factor = current_row[c];
+	for (std::size_t j = c + 1; j < m.cols; ++j)
+	{
+		if (!can_mul<T>(pivot, current_row[j])
+			|| !can_mul<T>(factor, pivot_row[j])
+			|| !can_sub<T>(pivot * current_row[j], factor * pivot_row[j]))
+		{
+			throw FractionOverflowError<T>("linalg::bareiss");
+		}
+		current_row[j] = (pivot * current_row[j] - factor * pivot_row[j]) / prev;
+	}
+	current_row[c] = T(0);
+}
+
+// Fraction-free elimination of the first elim_cols columns into row echelon
+// form. With several threads the rows below the pivot are split cyclically
+// between the workers and the pivot search runs in the barrier completion.
+template <Fraction_compatible T>
+Echelon bareiss (IntegerMatrix<T>& m, const std::size_t elim_cols, const unsigned threads)
+{
+	Echelon e{0, false, {}};
+	e.pivots.reserve(std::min(m.rows, elim_cols));
+	if (m.rows == 0)
+	{
+		return e;
+	}
+	T prev = T(1);
+	std::size_t r = 0;
+	std::size_t c = find_pivot(m, 0, 0, elim_cols, e.negated);
+	if (threads <= 1 || m.rows <= 2)
+	{
+		while (c < elim_cols)
+		{
+			for (std::size_t i = r + 1; i < m.rows; ++i)
+			{
+				eliminate_row(m, r, c, i, prev);
+			}
+			prev = m.row(r)[c];
+			e.pivots.push_back(c);
+			++r;
+			if (r == m.rows)
+			{
+				break;
+			}
+			c = find_pivot(m, r, c + 1, elim_cols, e.negated);
+		}
+		e.rank = r;
+		return e;
+	}
+
+	bool done = c >= elim_cols;
+	std::exception_ptr error;
+	std::mutex error_mutex;
+	auto advance = [&] () noexcept
+	{
+		if (error)
+		{
+			done = true;
+			return;
+		}
+		prev = m.row(r)[c];
+		e.pivots.push_back(c);
+		++r;
+		if (r == m.rows)
+		{
+			done = true;
+			return;
+		}
+		c = find_pivot(m, r, c + 1, elim_cols, e.negated);
+		done = c >= elim_cols;
+	};
+	std::barrier sync(threads, advance);
+	auto work = [&] (const unsigned w)
+	{
+		while (!done)
+		{
+			try
+			{
+				for (std::size_t i = r + 1 + w; i < m.rows; i += threads)
+				{
+					eliminate_row(m, r, c, i, prev);
+				}
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(error_mutex);
+				if (!error)
+				{
+					error = std::current_exception();
+				}
+			}
+			sync.arrive_and_wait();
+		}
+	};
+	std::vector<std::thread> workers;
+	for (unsigned w = 1; w < threads; ++w)
+	{
+		workers.emplace_back(work, w);
+	}
+	work(0);
+	for (std::thread& t : workers)
+	{
+		t.join();
+	}
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+	e.rank = r;
+	return e;
+}
+
+}
+
+
+
+template <Fraction_compatible T>
+Fraction<T> determinant (const Matrix<T>& a, const unsigned threads)
+{
+	if (a.rows() != a.cols())
+	{
+		throw std::invalid_argument("non-square matrix in tokox::linalg::determinant");
+	}
+	const std::size_t n = a.rows();
+	if (n == 0)
+	{
+		return Fraction<T>(1);
+	}
+	std::vector<T> scales;
+	detail::IntegerMatrix<T> m = detail::integer_form(a, Matrix<T>(n, 0), scales);
+	const detail::Echelon e = detail::bareiss(m, n, threads);
+	if (e.rank < n)
+	{
+		return Fraction<T>(0);
+	}
+	Fraction<T> result(m.row(n - 1)[n - 1]);
+	if (e.negated)
+	{
+		result = -result;
+	}
+	for (const T& s : scales)
+	{
+		result /= Fraction<T>(s);
+	}
+	return result;
+}
+
+template <Fraction_compatible T>
+std::size_t rank (const Matrix<T>& a, const unsigned threads)
+{
+	std::vector<T> scales;
+	detail::IntegerMatrix<T> m = detail::integer_form(a, Matrix<T>(a.rows(), 0), scales);
+	return detail::bareiss(m, a.cols(), threads).rank;
+}
+
+// Back substitution stays fraction-free: y = det * x is integral by Cramer's
+// rule, so every division by a diagonal entry is exact.
+template <Fraction_compatible T>
+Matrix<T> solve (const Matrix<T>& a, const Matrix<T>& b, const unsigned threads)
+{
+	if (a.rows() != a.cols())
+	{
+		throw std::invalid_argument("non-square matrix in tokox::linalg::solve");
+	}
+	if (a.rows() != b.rows())
+	{
+		throw std::invalid_argument("dimension mismatch in tokox::linalg::solve");
+	}
+	const std::size_t n = a.rows();
+	std::vector<T> scales;
+	detail::IntegerMatrix<T> m = detail::integer_form(a, b, scales);
+	const detail::Echelon e = detail::bareiss(m, n, threads);
+	if (e.rank < n)
+	{
+		throw MatrixIsSingularError("solve");
+	}
+	Matrix<T> x(n, b.cols());
+	if (n == 0)
+	{
+		return x;
+	}
+	const T det = m.row(n - 1)[n - 1];
+	tokox::detail::parallel_for(b.cols(), threads, [&] (const std::size_t k)
+	{
+		std::vector<T> y(n, T(0));
+		for (std::size_t i = n; i-- > 0;)
+		{
+			const T* r = m.row(i);
+			if (!can_mul<T>(det, r[n + k]))
+			{
+				throw FractionOverflowError<T>("linalg::solve");
+			}
+			T acc = det * r[n + k];
+			for (std::size_t j = i + 1; j < n; ++j)
+			{
+				if (!can_mul<T>(r[j], y[j]) || !can_sub<T>(acc, r[j] * y[j]))
+				{
+					throw FractionOverflowError<T>("linalg::solve");
+				}
+				acc -= r[j] * y[j];
+			}
+			y[i] = acc / r[i];
+			x(i, k) = Fraction<T>(y[i], det);
+		}
+	});
+	return x;
+}
+
+template <Fraction_compatible T>
+std::vector<Fraction<T>> solve (const Matrix<T>& a, const std::vector<Fraction<T>>& b, const unsigned threads)
+{
+	Matrix<T> rhs(b.size(), 1);
+	for (std::size_t i = 0; i < b.size(); ++i)
+	{
+		rhs(i, 0) = b[i];
+	}
+	const Matrix<T> x = solve(a, rhs, threads);
+	std::vector<Fraction<T>> result(x.rows());
+	for (std::size_t i = 0; i < x.rows(); ++i)
+	{
+		result[i] = x(i, 0);
+	}
+	return result;
+}
+
+template <Fraction_compatible T>
+Matrix<T> inverse (const Matrix<T>& a, const unsigned threads)
+{
+	if (a.rows() != a.cols())
+	{
+		throw std::invalid_argument("non-square matrix in tokox::linalg::inverse");
+	}
+	return solve(a, Matrix<T>::identity(a.rows()), threads);
+}
+
+}
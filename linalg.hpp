@@ -0,0 +1,90 @@
+#ifndef TOKOX_FRACTIONS_LINALG
+#define TOKOX_FRACTIONS_LINALG
+
+#include <cstddef>
+#include <vector>
+#include <initializer_list>
+#include <stdexcept>
+#include <exception>
+#include <thread>
+#include <barrier>
+#include <mutex>
+#include <algorithm>
+
+#include "fractions.hpp"
+#include "parallel.hpp"
+
+namespace tokox::linalg
+{
+
+class MatrixIsSingularError : public std::domain_error
+{
+public:
+	MatrixIsSingularError (const std::string& what):
+		std::domain_error("matrix is singular in tokox::linalg::" + what)
+	{}
+};
+
+template <Fraction_compatible T = int>
+class Matrix
+{
+public:
+	Matrix (const std::size_t rows = 0, const std::size_t cols = 0);
+	Matrix (std::initializer_list<std::initializer_list<Fraction<T>>> rows);
+
+	static Matrix identity (const std::size_t n);
+
+
+	Fraction<T>& operator() (const std::size_t r, const std::size_t c);
+	const Fraction<T>& operator() (const std::size_t r, const std::size_t c) const;
+
+	Fraction<T>* row (const std::size_t r);
+	const Fraction<T>* row (const std::size_t r) const;
+
+	std::size_t rows () const;
+	std::size_t cols () const;
+
+
+	Matrix& operator+= (const Matrix& other);
+	Matrix operator+ (const Matrix& other) const;
+
+	Matrix& operator-= (const Matrix& other);
+	Matrix operator- (const Matrix& other) const;
+
+	Matrix operator* (const Matrix& other) const;
+	std::vector<Fraction<T>> operator* (const std::vector<Fraction<T>>& v) const;
+
+	bool operator== (const Matrix& other) const;
+	bool operator!= (const Matrix& other) const;
+
+	Matrix transposed () const;
+
+	static constexpr std::size_t block_size = 32;
+
+private:
+	std::size_t _rows;
+	std::size_t _cols;
+	std::vector<Fraction<T>> _data;
+};
+
+
+template <Fraction_compatible T>
+Fraction<T> determinant (const Matrix<T>& a, const unsigned threads = 1);
+
+template <Fraction_compatible T>
+std::size_t rank (const Matrix<T>& a, const unsigned threads = 1);
+
+template <Fraction_compatible T>
+std::vector<Fraction<T>> solve (const Matrix<T>& a, const std::vector<Fraction<T>>& b, const unsigned threads = 1);
+
+template <Fraction_compatible T>
+Matrix<T> solve (const Matrix<T>& a, const Matrix<T>& b, const unsigned threads = 1);
+
+template <Fraction_compatible T>
+Matrix<T> inverse (const Matrix<T>& a, const unsigned threads = 1);
+
+}
+
+#include "linalg.cpp"
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef TOKOX_FRACTIONS_LOOKUP_TABLES
+#define TOKOX_FRACTIONS_LOOKUP_TABLES
+
+#include <cstddef>
+#include <cstdint>
+#include <concepts>
+#include <type_traits>
+
+// Bytes of compile-time tables Fraction may use for 8 and 16 bit integers;
+// 0 turns the table driven paths off.
+#ifndef TOKOX_FRACTIONS_LOOKUP_TABLE_BUDGET
+#define TOKOX_FRACTIONS_LOOKUP_TABLE_BUDGET 32768
+#endif
+
+namespace tokox
+{
+
+// gcd of all magnitudes up to 128: every int8_t pair, and the last Euclid
+// steps of an int16_t pair.
+struct SmallGcdTable
+{
+	static constexpr uint32_t size = 129;
+	uint8_t values[size][size];
+};
+
+constexpr SmallGcdTable make_small_gcd_table ()
+{
+	SmallGcdTable t{};
+	for (uint32_t a = 0; a < SmallGcdTable::size; ++a)
+	{
+		for (uint32_t b = 0; b < SmallGcdTable::size; ++b)
+		{
+			uint32_t x = a, y = b;
+			while (y != 0)
+			{
+				const uint32_t r = x % y;
+				x = y;
+				y = r;
+			}
+			t.values[a][b] = static_cast<uint8_t>(x);
+		}
+	}
+	return t;
+}
+
+inline constexpr SmallGcdTable small_gcd_table = make_small_gcd_table();
+
+template <typename T>
+inline constexpr bool use_lookup_tables = TOKOX_FRACTIONS_LOOKUP_TABLE_BUDGET >= sizeof(SmallGcdTable)
+	&& std::integral<T> && std::is_signed_v<T> && sizeof(T) <= 2;
+
+inline uint32_t small_gcd (uint32_t a, uint32_t b)
+{
+	while (a >= SmallGcdTable::size || b >= SmallGcdTable::size)
+	{
+		if (a < b)
+		{
+			const uint32_t t = a;
+			a = b;
+			b = t;
+		}
+		if (b == 0)
+		{
+			return a;
+		}
+		a %= b;
+	}
+	return small_gcd_table.values[a][b];
+}
+
+}
+
+#endif
@@ -0,0 +1,436 @@
+#include "modular.hpp"
+namespace tokox::modular
+{
+
+inline Prime::Prime (const uint64_t p):
+	_p(p)
+{
+	if (p % 2 == 0 || p <= (uint64_t(1) << 61) || p >= (uint64_t(1) << 62))
+	{
+		throw std::invalid_argument("modulus is not an odd number between 2^61 and 2^62 in tokox::modular::Prime");
+	}
+	uint64_t inverse = p;
+	for (int i = 0; i < 5; ++i)
+	{
+		inverse *= 2 - p * inverse;
+	}
+	_neg_inverse = uint64_t(0) - inverse;
+	_one = uint64_t(((unsigned __int128)(1) << 64) % p);
+	_r2 = uint64_t((unsigned __int128)(_one) * _one % p);
+}
+
+inline uint64_t Prime::modulus () const
+{
+	return _p;
+}
+
+// |x| < 2^64 < 8p, so a few subtractions replace the remainder.
+template <std::integral T>
+uint64_t Prime::from (const T x) const
+{
+	using U = std::make_unsigned_t<T>;
+	const bool negative = x < T(0);
+	uint64_t v = negative ? uint64_t(U(U(0) - U(x))) : uint64_t(x);
+	while (v >= _p)
+	{
+		v -= _p;
+	}
+	v = mul(v, _r2);
+	return negative ? sub(0, v) : v;
+}
+
+inline uint64_t Prime::to (const uint64_t x) const
+{
+	return reduce(x);
+}
+
+inline uint64_t Prime::one () const
+{
+	return _one;
+}
+
+inline uint64_t Prime::add (const uint64_t a, const uint64_t b) const
+{
+	const uint64_t s = a + b;
+	return s >= _p ? s - _p : s;
+}
+
+inline uint64_t Prime::sub (const uint64_t a, const uint64_t b) const
+{
+	return a >= b ? a - b : a + (_p - b);
+}
+
+inline uint64_t Prime::mul (const uint64_t a, const uint64_t b) const
+{
+	return reduce((unsigned __int128)(a) * b);
+}
+
+inline uint64_t Prime::inverse (const uint64_t a) const
+{
+	uint64_t result = _one;
+	uint64_t square = a;
+	for (uint64_t e = _p - 2; e != 0; e /= 2)
+	{
+		if (e % 2 == 1)
+		{
+			result = mul(result, square);
+		}
+		square = mul(square, square);
+	}
+	return result;
+}
+
+// t + m*p is divisible by 2^64 and below 2^127 for t < p*2^64.
+inline uint64_t Prime::reduce (const unsigned __int128 t) const
+{
+	const uint64_t m = uint64_t(t) * _neg_inverse;
+	const uint64_t u = uint64_t((t + (unsigned __int128)(m) * _p) >> 64);
+	return u >= _p ? u - _p : u;
+}
+
+
+
+namespace detail
+{
+
+// Unsigned 256-bit integer, enough for the product of four primes.
+struct Big
+{
+	std::array<uint64_t, 4> words{};
+
+	static Big from (const uint64_t x)
+	{
+		Big b;
+		b.words[0] = x;
+		return b;
+	}
+
+	int bit_width () const
+	{
+		for (std::size_t i = words.size(); i-- > 0;)
+		{
+			if (words[i] != 0)
+			{
+				return int(64 * i) + std::bit_width(words[i]);
+			}
+		}
+		return 0;
+	}
+
+	bool bit (const int i) const
+	{
+		return (words[i / 64] >> (i % 64)) & 1;
+	}
+
+	auto operator<=> (const Big& other) const
+	{
+		for (std::size_t i = words.size(); i-- > 0;)
+		{
+			if (words[i] != other.words[i])
+			{
+				return words[i] <=> other.words[i];
+			}
+		}
+		return std::strong_ordering::equal;
+	}
+
+	bool operator== (const Big& other) const = default;
+};
+
+inline void mul_add (Big& a, const uint64_t m, const uint64_t c)
+{
+	uint64_t carry = c;
+	for (uint64_t& w : a.words)
+	{
+		const unsigned __int128 t = (unsigned __int128)(w) * m + carry;
+		w = uint64_t(t);
+		carry = uint64_t(t >> 64);
+	}
+}
+
+inline void add (Big& a, const Big& b)
+{
+	unsigned carry = 0;
+	for (std::size_t i = 0; i < a.words.size(); ++i)
+	{
+		const unsigned __int128 t = (unsigned __int128)(a.words[i]) + b.words[i] + carry;
+		a.words[i] = uint64_t(t);
+		carry = unsigned(t >> 64);
+	}
+}
+
+inline void sub (Big& a, const Big& b)
+{
+	unsigned borrow = 0;
+	for (std::size_t i = 0; i < a.words.size(); ++i)
+	{
+		const uint64_t t = a.words[i] - b.words[i] - borrow;
+		borrow = a.words[i] < b.words[i] || (a.words[i] == b.words[i] && borrow);
+		a.words[i] = t;
+	}
+}
+
+inline Big mul (const Big& a, const Big& b)
+{
+	Big result;
+	for (std::size_t i = 0; i < a.words.size(); ++i)
+	{
+		uint64_t carry = 0;
+		for (std::size_t j = 0; i + j < result.words.size(); ++j)
+		{
+			const unsigned __int128 t = (unsigned __int128)(a.words[i]) * b.words[j] + result.words[i + j] + carry;
+			result.words[i + j] = uint64_t(t);
+			carry = uint64_t(t >> 64);
+		}
+	}
+	return result;
+}
+
+inline uint64_t mod (const Big& a, const uint64_t p)
+{
+	unsigned __int128 r = 0;
+	for (std::size_t i = a.words.size(); i-- > 0;)
+	{
+		r = ((r << 64) | a.words[i]) % p;
+	}
+	return uint64_t(r);
+}
+
+// Shift and subtract; only the reconstruction divides, a few hundred times.
+inline void divmod (const Big& a, const Big& b, Big& q, Big& r)
+{
+	q = Big();
+	r = Big();
+	for (int i = a.bit_width(); i-- > 0;)
+	{
+		mul_add(r, 2, a.bit(i));
+		if (r >= b)
+		{
+			sub(r, b);
+			q.words[i / 64] |= uint64_t(1) << (i % 64);
+		}
+	}
+}
+
+// Garner's step: x + m*k with k = (r - x) / m mod p is r modulo p and x
+// modulo m.
+inline void combine (Big& m, Big& x, const Prime& p, const uint64_t r)
+{
+	const uint64_t difference = p.sub(p.from(r), p.from(mod(x, p.modulus())));
+	const uint64_t k = p.to(p.mul(difference, p.inverse(p.from(mod(m, p.modulus())))));
+	Big step = m;
+	mul_add(step, k, 0);
+	add(x, step);
+	mul_add(m, p.modulus(), 0);
+}
+
+// Half-extended Euclid on (m, x): the first remainder r_i <= N with its
+// cofactor t_i gives x = r_i / t_i modulo m. With 2ND <= m every fraction with
+// |numerator| <= N and denominator <= D is found, and is unique. Once m covers
+// the range of T, N is max + 1 so that a numerator of T's min is found too; it
+// is rejected afterwards if its sign turns out positive.
+template <Fraction_compatible T>
+std::optional<Fraction<T>> reconstruct (const Big& m, const Big& x)
+{
+	const int k = (m.bit_width() - 2) / 2;
+	const uint64_t max = uint64_t(std::numeric_limits<T>::max());
+	const bool covered = k >= std::numeric_limits<T>::digits;
+	const Big numerator_bound = Big::from(covered ? max + 1 : uint64_t(1) << k);
+	const Big denominator_bound = Big::from(covered ? max : uint64_t(1) << k);
+	Big r0 = m, r1 = x;
+	Big t0, t1 = Big::from(1);
+	bool negative = false;
+	while (r1 > numerator_bound)
+	{
+		Big q, r;
+		divmod(r0, r1, q, r);
+		r0 = r1;
+		r1 = r;
+		Big t = mul(q, t1);
+		add(t, t0);
+		t0 = t1;
+		t1 = t;
+		negative = !negative;
+	}
+	if (t1 > denominator_bound)
+	{
+		return std::nullopt;
+	}
+	const uint64_t n = r1.words[0];
+	const uint64_t d = t1.words[0];
+	if ((n > max && !negative) || std::gcd(n, d) != 1)
+	{
+		return std::nullopt;
+	}
+	return Fraction<T>(negative ? T(uint64_t(0) - n) : T(n), T(d));
+}
+
+template <Fraction_compatible T>
+bool agrees (const Fraction<T>& f, const Prime& p, const uint64_t r)
+{
+	return p.mul(p.from(r), p.from(f.denominator())) == p.from(f.numerator());
+}
+
+}
+
+template <Fraction_compatible T, typename F>
+	requires (std::integral<T> && sizeof(T) <= 8 && std::is_invocable_r_v<std::optional<uint64_t>, const F&, const Prime&>)
+Fraction<T> evaluate (const F& residue, const unsigned threads)
+{
+	constexpr std::size_t max_combined = 4;
+	detail::Big m = detail::Big::from(1);
+	detail::Big x;
+	std::size_t combined = 0;
+	std::optional<Fraction<T>> candidate;
+	for (std::size_t next = 0; next < primes.size();)
+	{
+		const std::size_t batch = std::min<std::size_t>(std::max(threads, 1u), primes.size() - next);
+		std::vector<std::optional<uint64_t>> results(batch);
+		tokox::detail::parallel_for(batch, threads, [&] (const std::size_t i)
+		{
+			results[i] = residue(Prime(primes[next + i]));
+		});
+		for (std::size_t i = 0; i < batch; ++i)
+		{
+			if (!results[i])
+			{
+				continue;
+			}
+			const Prime p(primes[next + i]);
+			if (candidate && detail::agrees(*candidate, p, *results[i]))
+			{
+				return *candidate;
+			}
+			if (combined == max_combined)
+			{
+				throw FractionOverflowError<T>("modular::evaluate");
+			}
+			detail::combine(m, x, p, *results[i]);
+			++combined;
+			candidate = detail::reconstruct<T>(m, x);
+		}
+		next += batch;
+	}
+	throw FractionOverflowError<T>("modular::evaluate");
+}
+
+// a/b + n/d = (a*d + n*b)/(b*d) needs no inverse until the end.
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+Fraction<T> sum (std::span<const Fraction<T>> values, const unsigned threads)
+{
+	return evaluate<T>([values] (const Prime& p) -> std::optional<uint64_t>
+	{
+		uint64_t a = 0;
+		uint64_t b = p.one();
+		for (const Fraction<T>& v : values)
+		{
+			const uint64_t d = p.from(v.denominator());
+			if (d == 0)
+			{
+				return std::nullopt;
+			}
+			a = p.add(p.mul(a, d), p.mul(p.from(v.numerator()), b));
+			b = p.mul(b, d);
+		}
+		return p.to(p.mul(a, p.inverse(b)));
+	}, threads);
+}
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+Fraction<T> dot (std::span<const Fraction<T>> a, std::span<const Fraction<T>> b, const unsigned threads)
+{
+	if (a.size() != b.size())
+	{
+		throw std::invalid_argument("span sizes differ in tokox::modular::dot");
+	}
+	return evaluate<T>([a, b] (const Prime& p) -> std::optional<uint64_t>
+	{
+		uint64_t s = 0;
+		uint64_t t = p.one();
+		for (std::size_t i = 0; i < a.size(); ++i)
+		{
+			const uint64_t d = p.mul(p.from(a[i].denominator()), p.from(b[i].denominator()));
+			if (d == 0)
+			{
+				return std::nullopt;
+			}
+			const uint64_t n = p.mul(p.from(a[i].numerator()), p.from(b[i].numerator()));
+			s = p.add(p.mul(s, d), p.mul(n, t));
+			t = p.mul(t, d);
+		}
+		return p.to(p.mul(s, p.inverse(t)));
+	}, threads);
+}
+
+// The denominators are inverted together with one inverse and prefix
+// products; elimination then needs one inverse per pivot.
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+Fraction<T> determinant (const linalg::Matrix<T>& a, const unsigned threads)
+{
+	if (a.rows() != a.cols())
+	{
+		throw std::invalid_argument("non-square matrix in tokox::modular::determinant");
+	}
+	const std::size_t n = a.rows();
+	return evaluate<T>([&a, n] (const Prime& p) -> std::optional<uint64_t>
+	{
+		std::vector<uint64_t> m(n * n);
+		std::vector<uint64_t> prefix(n * n);
+		uint64_t product = p.one();
+		for (std::size_t i = 0; i < n * n; ++i)
+		{
+			const uint64_t d = p.from(a(i / n, i % n).denominator());
+			if (d == 0)
+			{
+				return std::nullopt;
+			}
+			prefix[i] = product;
+			product = p.mul(product, d);
+		}
+		uint64_t inverse = p.inverse(product);
+		for (std::size_t i = n * n; i-- > 0;)
+		{
+			const Fraction<T>& f = a(i / n, i % n);
+			m[i] = p.mul(p.from(f.numerator()), p.mul(inverse, prefix[i]));
+			inverse = p.mul(inverse, p.from(f.denominator()));
+		}
+		uint64_t det = p.one();
+		for (std::size_t c = 0; c < n; ++c)
+		{
+			std::size_t r = c;
+			while (r < n && m[r * n + c] == 0)
+			{
+				++r;
+			}
+			if (r == n)
+			{
+				return 0;
+			}
+			if (r != c)
+			{
+				std::swap_ranges(m.begin() + r * n + c, m.begin() + r * n + n, m.begin() + c * n + c);
+				det = p.sub(0, det);
+			}
+			det = p.mul(det, m[c * n + c]);
+			const uint64_t pivot_inverse = p.inverse(m[c * n + c]);
+			for (std::size_t i = c + 1; i < n; ++i)
+			{
+				const uint64_t factor = p.mul(m[i * n + c], pivot_inverse);
+				if (factor == 0)
+				{
+					continue;
+				}
+				for (std::size_t j = c + 1; j < n; ++j)
+				{
+					m[i * n + j] = p.sub(m[i * n + j], p.mul(factor, m[c * n + j]));
+				}
+			}
+		}
+		return p.to(det);
+	}, threads);
+}
+
+}
@@ -0,0 +1,95 @@
+#ifndef TOKOX_FRACTIONS_MODULAR
+#define TOKOX_FRACTIONS_MODULAR
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "fractions.hpp"
+#include "parallel.hpp"
+
+namespace tokox::linalg
+{
+
+template <Fraction_compatible T>
+class Matrix;
+
+}
+
+namespace tokox::modular
+{
+
+// Arithmetic modulo an odd number below 2^62 in Montgomery form: a product is
+// one 128-bit multiplication and a reduction without any division. Values
+// passed between the members are in Montgomery form; from() and to() convert.
+class Prime
+{
+public:
+	explicit Prime (const uint64_t p);
+
+	uint64_t modulus () const;
+
+	template <std::integral T>
+	uint64_t from (const T x) const;
+	uint64_t to (const uint64_t x) const;
+
+	uint64_t one () const;
+	uint64_t add (const uint64_t a, const uint64_t b) const;
+	uint64_t sub (const uint64_t a, const uint64_t b) const;
+	uint64_t mul (const uint64_t a, const uint64_t b) const;
+	uint64_t inverse (const uint64_t a) const;
+
+private:
+	uint64_t reduce (const unsigned __int128 t) const;
+
+	uint64_t _p;
+	uint64_t _neg_inverse;
+	uint64_t _r2;
+	uint64_t _one;
+};
+
+// The largest primes below 2^62. Four of them bound every reconstruction of a
+// Fraction of up to 64 bits; the rest stand in for primes that divide an input
+// denominator.
+inline constexpr std::array<uint64_t, 8> primes = {
+	(uint64_t(1) << 62) - 57, (uint64_t(1) << 62) - 87, (uint64_t(1) << 62) - 117, (uint64_t(1) << 62) - 143,
+	(uint64_t(1) << 62) - 153, (uint64_t(1) << 62) - 167, (uint64_t(1) << 62) - 171, (uint64_t(1) << 62) - 195
+};
+
+// Calls residue for one prime after another, threads primes at a time, and
+// combines the residues by CRT. After every prime the result is rationally
+// reconstructed; it is returned as soon as the next prime agrees with it.
+// residue returns the result modulo the prime in [0, p), or std::nullopt when
+// the prime divides a denominator of the input, which skips that prime.
+template <Fraction_compatible T, typename F>
+	requires (std::integral<T> && sizeof(T) <= 8 && std::is_invocable_r_v<std::optional<uint64_t>, const F&, const Prime&>)
+Fraction<T> evaluate (const F& residue, const unsigned threads = 1);
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+Fraction<T> sum (std::span<const Fraction<T>> values, const unsigned threads = 1);
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+Fraction<T> dot (std::span<const Fraction<T>> a, std::span<const Fraction<T>> b, const unsigned threads = 1);
+
+template <Fraction_compatible T>
+	requires (std::integral<T> && sizeof(T) <= 8)
+Fraction<T> determinant (const linalg::Matrix<T>& a, const unsigned threads = 1);
+
+}
+
+#include "modular.cpp"
+
+#endif
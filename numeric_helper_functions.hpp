@@ -7,6 +7,7 @@
 #include <numeric>
 
 #include "util.hpp"
+#include "lookup_tables.hpp"
 
 namespace tokox
 {
@@ -208,7 +209,14 @@ template<std::integral T>
 	requires gcd_computable<T>
 T gcd (const T& a, const T& b)
 {
-	return std::gcd<T, T>(a, b);
+	if constexpr (use_lookup_tables<T>)
+	{
+		return T(small_gcd(a < T(0) ? -int32_t(a) : int32_t(a), b < T(0) ? -int32_t(b) : int32_t(b)));
+	}
+	else
+	{
+		return std::gcd<T, T>(a, b);
+	}
 }
 
 
@@ -235,6 +243,85 @@ T lcm (const T& a, const T& b)
 	return p * b;
 }
 
+
+template <typename T>
+	requires can_checkable<T>
+int ctz (const T& a)
+{
+	if (a == T(0))
+	{
+		return 0;
+	}
+	int count = 0;
+	T x = a;
+	while ((x / T(2)) * T(2) == x)
+	{
+		x = x / T(2);
+		++count;
+	}
+	return count;
+}
+
+template <std::integral T>
+	requires can_checkable<T>
+int ctz (const T& a)
+{
+	if (a == T(0))
+	{
+		return 0;
+	}
+	if constexpr (sizeof(T) <= sizeof(unsigned long long))
+	{
+		return __builtin_ctzll(static_cast<unsigned long long>(a));
+	}
+	else
+	{
+		const unsigned long long low = static_cast<unsigned long long>(a);
+		if (low != 0)
+		{
+			return __builtin_ctzll(low);
+		}
+		return 64 + ctz<T>(a >> 64);
+	}
+}
+
+
+template <typename T>
+	requires can_checkable<T>
+int bit_width (const T& a)
+{
+	int count = 0;
+	T x = a;
+	while (x != T(0))
+	{
+		x = x / T(2);
+		++count;
+	}
+	return count;
+}
+
+template <std::integral T>
+	requires can_checkable<T>
+int bit_width (const T& a)
+{
+	using U = std::make_unsigned_t<T>;
+	const U magnitude = a < T(0) ? U(U(0) - U(a)) : U(a);
+	if constexpr (sizeof(T) <= sizeof(unsigned long long))
+	{
+		return magnitude == 0 ? 0 : 64 - __builtin_clzll(static_cast<unsigned long long>(magnitude));
+	}
+	else
+	{
+		const unsigned long long high = static_cast<unsigned long long>(magnitude >> 64);
+		if (high != 0)
+		{
+			return 128 - __builtin_clzll(high);
+		}
+		const unsigned long long low = static_cast<unsigned long long>(magnitude);
+		return low == 0 ? 0 : 64 - __builtin_clzll(low);
+	}
+}
+
 }
 
 #endif
@@ -0,0 +1,64 @@
+#ifndef TOKOX_FRACTIONS_PARALLEL
+#define TOKOX_FRACTIONS_PARALLEL
+
+#include <cstddef>
+#include <vector>
+#include <exception>
+#include <thread>
+#include <mutex>
+
+namespace tokox::detail
+{
+
+// Runs f(i) for every i < count, split round-robin over threads threads (the
+// calling one included). The first exception is rethrown once all are done.
+template <typename F>
+void parallel_for (const std::size_t count, const unsigned threads, F f)
+{
+	if (threads <= 1 || count <= 1)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			f(i);
+		}
+		return;
+	}
+	std::exception_ptr error;
+	std::mutex error_mutex;
+	auto work = [&] (const unsigned w)
+	{
+		try
+		{
+			for (std::size_t i = w; i < count; i += threads)
+			{
+				f(i);
+			}
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(error_mutex);
+			if (!error)
+			{
+				error = std::current_exception();
+			}
+		}
+	};
+	std::vector<std::thread> workers;
+	for (unsigned w = 1; w < threads; ++w)
+	{
+		workers.emplace_back(work, w);
+	}
+	work(0);
+	for (std::thread& t : workers)
+	{
+		t.join();
+	}
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+}
+
+#endif
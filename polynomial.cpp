@@ -0,0 +1,499 @@
+#include "polynomial.hpp"
+namespace tokox
+{
+
+template <Fraction_compatible T>
+RationalPolynomial<T>::RationalPolynomial ():
+	_numerators(),
+	_denominator(T(1))
+{}
+
+template <Fraction_compatible T>
+RationalPolynomial<T>::RationalPolynomial (const Fraction<T>& c):
+	_numerators{c.numerator()},
+	_denominator(c.denominator())
+{
+	normalize();
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T>::RationalPolynomial (std::initializer_list<Fraction<T>> coefficients):
+	RationalPolynomial(std::span<const Fraction<T>>(coefficients.begin(), coefficients.size()))
+{}
+
+template <Fraction_compatible T>
+RationalPolynomial<T>::RationalPolynomial (std::span<const Fraction<T>> coefficients):
+	_numerators(),
+	_denominator(T(1))
+{
+	T common = T(1);
+	try
+	{
+		for (const Fraction<T>& c : coefficients)
+		{
+			common = lcm<T>(common, c.reduce().denominator());
+		}
+	}
+	catch (std::overflow_error&)
+	{
+		throw FractionOverflowError<T>("RationalPolynomial::RationalPolynomial");
+	}
+	_numerators.reserve(coefficients.size());
+	for (const Fraction<T>& c : coefficients)
+	{
+		_numerators.push_back(checked_mul(c.numerator(), common / c.denominator(), "RationalPolynomial::RationalPolynomial"));
+	}
+	_denominator = common;
+	normalize();
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T>::RationalPolynomial (std::vector<T> numerators, const T denominator):
+	_numerators(std::move(numerators)),
+	_denominator(denominator)
+{
+	if (_denominator == T(0))
+	{
+		throw FractionDenominatorIsZeroError<T>("RationalPolynomial::RationalPolynomial");
+	}
+	normalize();
+}
+
+
+
+// -1 for the zero polynomial.
+template <Fraction_compatible T>
+std::ptrdiff_t RationalPolynomial<T>::degree () const
+{
+	return std::ptrdiff_t(_numerators.size()) - 1;
+}
+
+template <Fraction_compatible T>
+Fraction<T> RationalPolynomial<T>::operator[] (const std::size_t i) const
+{
+	return i < _numerators.size() ? Fraction<T>(_numerators[i], _denominator) : Fraction<T>(T(0));
+}
+
+template <Fraction_compatible T>
+std::vector<Fraction<T>> RationalPolynomial<T>::coefficients () const
+{
+	std::vector<Fraction<T>> result;
+	result.reserve(_numerators.size());
+	for (const T& c : _numerators)
+	{
+		result.emplace_back(c, _denominator);
+	}
+	return result;
+}
+
+template <Fraction_compatible T>
+const std::vector<T>& RationalPolynomial<T>::numerators () const
+{
+	return _numerators;
+}
+
+template <Fraction_compatible T>
+T RationalPolynomial<T>::denominator () const
+{
+	return _denominator;
+}
+
+
+
+template <Fraction_compatible T>
+RationalPolynomial<T>& RationalPolynomial<T>::add (const RationalPolynomial& other, const bool subtract)
+{
+	const char* where = subtract ? "RationalPolynomial::operator-=" : "RationalPolynomial::operator+=";
+	T common;
+	try
+	{
+		common = lcm<T>(_denominator, other._denominator);
+	}
+	catch (std::overflow_error&)
+	{
+		throw FractionOverflowError<T>(where);
+	}
+	const T f1 = common / _denominator;
+	const T f2 = common / other._denominator;
+	_numerators.resize(std::max(_numerators.size(), other._numerators.size()), T(0));
+	for (std::size_t i = 0; i < _numerators.size(); ++i)
+	{
+		const T a = f1 == T(1) ? _numerators[i] : checked_mul(_numerators[i], f1, where);
+		const T b = i < other._numerators.size() ? checked_mul(other._numerators[i], f2, where) : T(0);
+		_numerators[i] = subtract ? checked_sub(a, b, where) : checked_add(a, b, where);
+	}
+	_denominator = common;
+	normalize();
+	return *this;
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T>& RationalPolynomial<T>::operator+= (const RationalPolynomial& other)
+{
+	return add(other, false);
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T> RationalPolynomial<T>::operator+ (const RationalPolynomial& other) const
+{
+	return RationalPolynomial(*this) += other;
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T>& RationalPolynomial<T>::operator-= (const RationalPolynomial& other)
+{
+	return add(other, true);
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T> RationalPolynomial<T>::operator- (const RationalPolynomial& other) const
+{
+	return RationalPolynomial(*this) -= other;
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T> RationalPolynomial<T>::operator- () const
+{
+	return RationalPolynomial() -= *this;
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T>& RationalPolynomial<T>::operator*= (const RationalPolynomial& other)
+{
+	if (_numerators.empty() || other._numerators.empty())
+	{
+		*this = RationalPolynomial();
+		return *this;
+	}
+	_numerators = multiply(_numerators, other._numerators);
+	_denominator = checked_mul(_denominator, other._denominator, "RationalPolynomial::operator*=");
+	normalize();
+	return *this;
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T> RationalPolynomial<T>::operator* (const RationalPolynomial& other) const
+{
+	return RationalPolynomial(*this) *= other;
+}
+
+
+
+// Pseudo-division that keeps s*A = Q*B + R for the integer parts. Each step
+// scales by lc(B)/g instead of lc(B), with g the gcd of lc(B) and the leading
+// coefficient being cancelled, so s only grows as much as it has to.
+template <Fraction_compatible T>
+std::pair<RationalPolynomial<T>, RationalPolynomial<T>> RationalPolynomial<T>::divmod (const RationalPolynomial& divisor) const
+{
+	const char* where = "RationalPolynomial::divmod";
+	if (divisor._numerators.empty())
+	{
+		throw FractionDenominatorIsZeroError<T>(where);
+	}
+	const std::ptrdiff_t n = degree();
+	const std::ptrdiff_t m = divisor.degree();
+	if (n < m)
+	{
+		return {RationalPolynomial(), *this};
+	}
+	const std::vector<T>& b = divisor._numerators;
+	const T lead = b.back();
+	std::vector<T> r = _numerators;
+	std::vector<T> q(n - m + 1, T(0));
+	T s = T(1);
+	for (std::ptrdiff_t k = n - m; k >= 0; --k)
+	{
+		const T top = r[k + m];
+		if (top == T(0))
+		{
+			continue;
+		}
+		const T g = gcd<T>(top, lead);
+		T scale = lead / g;
+		T factor = top / g;
+		if (scale < T(0))
+		{
+			if (!can_neg<T>(scale) || !can_neg<T>(factor))
+			{
+				throw FractionOverflowError<T>(where);
+			}
+			scale = -scale;
+			factor = -factor;
+		}
+		if (scale != T(1))
+		{
+			s = checked_mul(s, scale, where);
+			for (T& c : q)
+			{
+				c = checked_mul(c, scale, where);
+			}
+			for (std::ptrdiff_t j = 0; j <= k + m; ++j)
+			{
+				r[j] = checked_mul(r[j], scale, where);
+			}
+		}
+		q[k] = factor;
+		for (std::ptrdiff_t j = 0; j <= m; ++j)
+		{
+			r[k + j] = checked_sub(r[k + j], checked_mul(factor, b[j], where), where);
+		}
+	}
+	r.resize(m);
+	const T denominator = checked_mul(s, _denominator, where);
+	RationalPolynomial quotient(std::move(q), denominator);
+	quotient *= RationalPolynomial(Fraction<T>(divisor._denominator));
+	return {quotient, RationalPolynomial(std::move(r), denominator)};
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T> RationalPolynomial<T>::operator/ (const RationalPolynomial& divisor) const
+{
+	return divmod(divisor).first;
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T> RationalPolynomial<T>::operator% (const RationalPolynomial& divisor) const
+{
+	return divmod(divisor).second;
+}
+
+
+
+template <Fraction_compatible T>
+bool RationalPolynomial<T>::operator== (const RationalPolynomial& other) const
+{
+	return _denominator == other._denominator && _numerators == other._numerators;
+}
+
+template <Fraction_compatible T>
+bool RationalPolynomial<T>::operator!= (const RationalPolynomial& other) const
+{
+	return !((*this) == other);
+}
+
+
+
+// Horner on p/q with every term over q^degree, so nothing is reduced until the
+// end; when that overflows the reducing Fraction arithmetic takes over.
+template <Fraction_compatible T>
+Fraction<T> RationalPolynomial<T>::operator() (const Fraction<T>& x) const
+{
+	if (_numerators.empty())
+	{
+		return Fraction<T>(T(0));
+	}
+	x.reduce();
+	const T p = x.numerator();
+	const T q = x.denominator();
+	try
+	{
+		T acc = _numerators.back();
+		T scale = T(1);
+		for (std::size_t i = _numerators.size() - 1; i-- > 0;)
+		{
+			scale = checked_mul(scale, q, "RationalPolynomial::operator()");
+			acc = checked_add(checked_mul(acc, p, "RationalPolynomial::operator()"), checked_mul(_numerators[i], scale, "RationalPolynomial::operator()"), "RationalPolynomial::operator()");
+		}
+		return Fraction<T>(acc, checked_mul(_denominator, scale, "RationalPolynomial::operator()"));
+	}
+	catch (FractionOverflowError<T>&)
+	{
+		Fraction<T> acc(_numerators.back());
+		for (std::size_t i = _numerators.size() - 1; i-- > 0;)
+		{
+			acc = acc * x + Fraction<T>(_numerators[i]);
+		}
+		return acc / Fraction<T>(_denominator);
+	}
+}
+
+template <Fraction_compatible T>
+RationalPolynomial<T> RationalPolynomial<T>::derivative () const
+{
+	std::vector<T> result;
+	if (_numerators.size() > 1)
+	{
+		result.reserve(_numerators.size() - 1);
+		T i = T(1);
+		for (std::size_t k = 1; k < _numerators.size(); ++k, ++i)
+		{
+			result.push_back(checked_mul(_numerators[k], i, "RationalPolynomial::derivative"));
+		}
+	}
+	return RationalPolynomial(std::move(result), _denominator);
+}
+
+
+
+template <Fraction_compatible T>
+void RationalPolynomial<T>::normalize ()
+{
+	while (!_numerators.empty() && _numerators.back() == T(0))
+	{
+		_numerators.pop_back();
+	}
+	if (_numerators.empty())
+	{
+		_denominator = T(1);
+		return;
+	}
+	if (_denominator < T(0))
+	{
+		if (!can_neg<T>(_denominator))
+		{
+			throw FractionOverflowError<T>("RationalPolynomial::normalize");
+		}
+		_denominator = -_denominator;
+		for (T& c : _numerators)
+		{
+			if (!can_neg<T>(c))
+			{
+				throw FractionOverflowError<T>("RationalPolynomial::normalize");
+			}
+			c = -c;
+		}
+	}
+	T g = _denominator;
+	for (std::size_t i = 0; i < _numerators.size() && g != T(1); ++i)
+	{
+		g = gcd<T>(g, _numerators[i]);
+	}
+	if (g != T(1))
+	{
+		for (T& c : _numerators)
+		{
+			c /= g;
+		}
+		_denominator /= g;
+	}
+}
+
+template <Fraction_compatible T>
+T RationalPolynomial<T>::checked_add (const T& a, const T& b, const char* where)
+{
+	if (!can_add<T>(a, b))
+	{
+		throw FractionOverflowError<T>(where);
+	}
+	return a + b;
+}
+
+template <Fraction_compatible T>
+T RationalPolynomial<T>::checked_sub (const T& a, const T& b, const char* where)
+{
+	if (!can_sub<T>(a, b))
+	{
+		throw FractionOverflowError<T>(where);
+	}
+	return a - b;
+}
+
+template <Fraction_compatible T>
+T RationalPolynomial<T>::checked_mul (const T& a, const T& b, const char* where)
+{
+	if (!can_mul<T>(a, b))
+	{
+		throw FractionOverflowError<T>(where);
+	}
+	return a * b;
+}
+
+template <Fraction_compatible T>
+void RationalPolynomial<T>::schoolbook (std::span<const T> a, std::span<const T> b, std::span<T> out)
+{
+	for (std::size_t i = 0; i < a.size(); ++i)
+	{
+		if (a[i] == T(0))
+		{
+			continue;
+		}
+		for (std::size_t j = 0; j < b.size(); ++j)
+		{
+			out[i + j] = checked_add(out[i + j], checked_mul(a[i], b[j], "RationalPolynomial::operator*="), "RationalPolynomial::operator*=");
+		}
+	}
+}
+
+// Adds a*b to out for a and b of equal length: three half size products,
+// (a0 + a1)(b0 + b1) - a0*b0 - a1*b1 being the middle one.
+template <Fraction_compatible T>
+void RationalPolynomial<T>::karatsuba (std::span<const T> a, std::span<const T> b, std::span<T> out)
+{
+	const std::size_t n = a.size();
+	if (n < karatsuba_threshold)
+	{
+		schoolbook(a, b, out);
+		return;
+	}
+	const char* where = "RationalPolynomial::operator*=";
+	const std::size_t h = n / 2;
+	std::vector<T> low(2 * h - 1, T(0));
+	std::vector<T> high(2 * (n - h) - 1, T(0));
+	std::vector<T> middle(2 * (n - h) - 1, T(0));
+	karatsuba(a.first(h), b.first(h), low);
+	karatsuba(a.subspan(h), b.subspan(h), high);
+	std::vector<T> sa(a.begin() + h, a.end());
+	std::vector<T> sb(b.begin() + h, b.end());
+	for (std::size_t i = 0; i < h; ++i)
+	{
+		sa[i] = checked_add(sa[i], a[i], where);
+		sb[i] = checked_add(sb[i], b[i], where);
+	}
+	karatsuba(sa, sb, middle);
+	for (std::size_t i = 0; i < low.size(); ++i)
+	{
+		middle[i] = checked_sub(middle[i], low[i], where);
+		out[i] = checked_add(out[i], low[i], where);
+	}
+	for (std::size_t i = 0; i < high.size(); ++i)
+	{
+		middle[i] = checked_sub(middle[i], high[i], where);
+		out[2 * h + i] = checked_add(out[2 * h + i], high[i], where);
+	}
+	for (std::size_t i = 0; i < middle.size(); ++i)
+	{
+		out[h + i] = checked_add(out[h + i], middle[i], where);
+	}
+}
+
+// The longer factor is cut into pieces as long as the shorter one. Karatsuba's
+// partial sums can overflow where the schoolbook ones do not, so an overflow
+// there retries the schoolbook way.
+template <Fraction_compatible T>
+std::vector<T> RationalPolynomial<T>::multiply (std::span<const T> a, std::span<const T> b)
+{
+	if (a.size() < b.size())
+	{
+		std::swap(a, b);
+	}
+	std::vector<T> out(a.size() + b.size() - 1, T(0));
+	if (b.size() < karatsuba_threshold)
+	{
+		schoolbook(a, b, out);
+		return out;
+	}
+	try
+	{
+		std::vector<T> piece(b.size());
+		std::vector<T> part(2 * b.size() - 1);
+		for (std::size_t start = 0; start < a.size(); start += b.size())
+		{
+			const std::size_t length = std::min(b.size(), a.size() - start);
+			std::fill(std::copy(a.begin() + start, a.begin() + start + length, piece.begin()), piece.end(), T(0));
+			std::fill(part.begin(), part.end(), T(0));
+			karatsuba(piece, b, part);
+			for (std::size_t k = 0; k < part.size() && start + k < out.size(); ++k)
+			{
+				out[start + k] = checked_add(out[start + k], part[k], "RationalPolynomial::operator*=");
+			}
+		}
+	}
+	catch (FractionOverflowError<T>&)
+	{
+		std::fill(out.begin(), out.end(), T(0));
+		schoolbook(a, b, out);
+	}
+	return out;
+}
+
+}
@@ -0,0 +1,83 @@
+#ifndef TOKOX_FRACTIONS_POLYNOMIAL
+#define TOKOX_FRACTIONS_POLYNOMIAL
+
+#include <cstddef>
+#include <algorithm>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "fractions.hpp"
+
+namespace tokox
+{
+
+// Polynomial with rational coefficients kept as integer numerators over one
+// shared positive denominator. Every operation works on the integers and ends
+// with a single normalization that strips trailing zeros and divides out the
+// gcd of the denominator and all numerators, so equal polynomials have equal
+// representations.
+template <Fraction_compatible T = int>
+class RationalPolynomial
+{
+public:
+	RationalPolynomial ();
+	RationalPolynomial (const Fraction<T>& c);
+	RationalPolynomial (std::initializer_list<Fraction<T>> coefficients);
+	explicit RationalPolynomial (std::span<const Fraction<T>> coefficients);
+	RationalPolynomial (std::vector<T> numerators, const T denominator);
+
+
+	std::ptrdiff_t degree () const;
+	Fraction<T> operator[] (const std::size_t i) const;
+	std::vector<Fraction<T>> coefficients () const;
+
+	const std::vector<T>& numerators () const;
+	T denominator () const;
+
+
+	RationalPolynomial& operator+= (const RationalPolynomial& other);
+	RationalPolynomial operator+ (const RationalPolynomial& other) const;
+
+	RationalPolynomial& operator-= (const RationalPolynomial& other);
+	RationalPolynomial operator- (const RationalPolynomial& other) const;
+	RationalPolynomial operator- () const;
+
+	RationalPolynomial& operator*= (const RationalPolynomial& other);
+	RationalPolynomial operator* (const RationalPolynomial& other) const;
+
+	std::pair<RationalPolynomial, RationalPolynomial> divmod (const RationalPolynomial& divisor) const;
+	RationalPolynomial operator/ (const RationalPolynomial& divisor) const;
+	RationalPolynomial operator% (const RationalPolynomial& divisor) const;
+
+	bool operator== (const RationalPolynomial& other) const;
+	bool operator!= (const RationalPolynomial& other) const;
+
+
+	Fraction<T> operator() (const Fraction<T>& x) const;
+	RationalPolynomial derivative () const;
+
+	static constexpr std::size_t karatsuba_threshold = 32;
+
+private:
+	void normalize ();
+	RationalPolynomial& add (const RationalPolynomial& other, const bool subtract);
+
+	static T checked_add (const T& a, const T& b, const char* where);
+	static T checked_sub (const T& a, const T& b, const char* where);
+	static T checked_mul (const T& a, const T& b, const char* where);
+	static void schoolbook (std::span<const T> a, std::span<const T> b, std::span<T> out);
+	static void karatsuba (std::span<const T> a, std::span<const T> b, std::span<T> out);
+	static std::vector<T> multiply (std::span<const T> a, std::span<const T> b);
+
+	std::vector<T> _numerators;
+	T _denominator;
+};
+
+}
+
+#include "polynomial.cpp"
+
+#endif
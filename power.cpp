@@ -0,0 +1,259 @@
+#include "power.hpp"
+namespace tokox
+{
+
+// The bit length of |x|^e lies between e*(b-1)+1 and e*b for a b bit x, so
+// most overflows are reported before multiplying and most powers that fit
+// are computed without any check.
+template <OverflowPolicy P, Fraction_compatible T>
+T integer_power (const T& x, std::uintmax_t e)
+{
+	if (x == T(0) || x == T(1))
+	{
+		return e == 0 ? T(1) : x;
+	}
+	if (x == T(-1))
+	{
+		return e % 2 == 0 ? T(1) : x;
+	}
+	bool checks = false;
+	if constexpr (P == OverflowPolicy::checked && std::numeric_limits<T>::is_bounded)
+	{
+		const std::uintmax_t digits = std::numeric_limits<T>::digits;
+		const std::uintmax_t b = bit_width<T>(x);
+		if (e > digits || e * (b - 1) + 1 > digits + 1)
+		{
+			throw FractionOverflowError<T>("pow");
+		}
+		checks = e * b > digits;
+	}
+	T result = T(1);
+	T square = x;
+	while (true)
+	{
+		if (e % 2 == 1)
+		{
+			if (checks && !can_mul<T>(result, square))
+			{
+				throw FractionOverflowError<T>("pow");
+			}
+			result = raw_mul<P, T>(result, square);
+		}
+		e /= 2;
+		if (e == 0)
+		{
+			return result;
+		}
+		if (checks && !can_mul<T>(square, square))
+		{
+			throw FractionOverflowError<T>("pow");
+		}
+		square = raw_mul<P, T>(square, square);
+	}
+}
+
+// Sign of r^n - x for r, x >= 0; a power that overflows is greater.
+template <Fraction_compatible T>
+int compare_power (const T& r, const unsigned n, const T& x)
+{
+	if (r == T(0) || r == T(1))
+	{
+		return r < x ? -1 : (r == x ? 0 : 1);
+	}
+	T p = T(1);
+	for (unsigned i = 0; i < n; ++i)
+	{
+		if (!can_mul<T>(p, r))
+		{
+			return 1;
+		}
+		p = p * r;
+		if (p > x)
+		{
+			return 1;
+		}
+	}
+	return p < x ? -1 : 0;
+}
+
+// Largest r with r^n <= x, for x >= 0 and n >= 2.
+template <Fraction_compatible T>
+T integer_root (const T& x, const unsigned n)
+{
+	if (x < T(2))
+	{
+		return x;
+	}
+	const unsigned b = bit_width<T>(x);
+	T lo = T(1);
+	T hi = T(1);
+	for (unsigned i = 0; i < (b + n - 1) / n; ++i)
+	{
+		hi = hi * T(2);
+	}
+	while (hi - lo > T(1))
+	{
+		const T mid = lo + (hi - lo) / T(2);
+		if (compare_power<T>(mid, n, x) <= 0)
+		{
+			lo = mid;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+// Square-and-multiply on the reduced numerator and denominator: they stay
+// coprime, so no gcd is needed after the first reduction.
+template <Fraction_compatible T, OverflowPolicy P, std::integral E>
+Fraction<T, P> pow (const Fraction<T, P>& f, const E e)
+{
+	f.reduce();
+	if (e < E(0) && f.numerator() == T(0))
+	{
+		throw FractionDenominatorIsZeroError<T>("pow");
+	}
+	const std::uintmax_t magnitude = e < E(0) ? std::uintmax_t(0) - std::uintmax_t(e) : std::uintmax_t(e);
+	constexpr OverflowPolicy Q = P == OverflowPolicy::saturating ? OverflowPolicy::checked : P;
+	try
+	{
+		const T n = integer_power<Q, T>(f.numerator(), magnitude);
+		const T d = integer_power<Q, T>(f.denominator(), magnitude);
+		return e < E(0) ? Fraction<T, P>(d, n) : Fraction<T, P>(n, d);
+	}
+	catch (FractionOverflowError<T>&)
+	{
+		if constexpr (P != OverflowPolicy::saturating)
+		{
+			throw;
+		}
+		Fraction<T, P> result(T(1));
+		Fraction<T, P> square(e < E(0) ? f.inverted() : f);
+		for (std::uintmax_t k = magnitude; k != 0; k /= 2)
+		{
+			if (k % 2 == 1)
+			{
+				result *= square;
+			}
+			if (k > 1)
+			{
+				square *= square;
+			}
+		}
+		return result;
+	}
+}
+
+template <Fraction_compatible T, OverflowPolicy P>
+std::optional<Fraction<T, P>> exact_root (const Fraction<T, P>& f, const unsigned n)
+{
+	if (n == 0)
+	{
+		throw std::invalid_argument("n is zero in tokox::exact_root");
+	}
+	f.reduce();
+	if (n == 1)
+	{
+		return f;
+	}
+	const T num = f.numerator();
+	const T den = f.denominator();
+	if (num < T(0) && n % 2 == 0)
+	{
+		return std::nullopt;
+	}
+	const T s = integer_root<T>(den, n);
+	if (compare_power<T>(s, n, den) != 0)
+	{
+		return std::nullopt;
+	}
+	if (num >= T(0))
+	{
+		const T r = integer_root<T>(num, n);
+		if (compare_power<T>(r, n, num) != 0)
+		{
+			return std::nullopt;
+		}
+		return Fraction<T, P>(r, s);
+	}
+	// |num| - 1 always fits, and the root of |num| is its root or one more.
+	const T r = integer_root<T>(-(num + T(1)), n);
+	for (const T candidate : {-r, -r - T(1)})
+	{
+		try
+		{
+			if (integer_power<OverflowPolicy::checked, T>(candidate, n) == num)
+			{
+				return Fraction<T, P>(candidate, s);
+			}
+		}
+		catch (FractionOverflowError<T>&)
+		{
+		}
+	}
+	return std::nullopt;
+}
+
+// Rational roots are exact; otherwise the root is evaluated in long double
+// and the best approximation with denominator at most max_denominator is
+// read off its continued fraction expansion.
+template <Fraction_compatible T, OverflowPolicy P>
+	requires std::integral<T>
+Fraction<T, P> root_approx (const Fraction<T, P>& f, const unsigned n, const std::type_identity_t<T> max_denominator)
+{
+	if (max_denominator < T(1))
+	{
+		throw std::invalid_argument("max_denominator < 1 in tokox::root_approx");
+	}
+	if (const std::optional<Fraction<T, P>> exact = exact_root(f, n))
+	{
+		return exact->limit_denominator(max_denominator);
+	}
+	const bool negative = f.numerator() < T(0);
+	if (negative && n % 2 == 0)
+	{
+		throw std::domain_error("even root of a negative value in tokox::root_approx");
+	}
+	const long double x = std::pow(std::fabs(static_cast<long double>(f.numerator()) / static_cast<long double>(f.denominator())), 1.0L / n);
+	const long double limit = std::ldexp(1.0L, std::numeric_limits<T>::digits);
+	const long double max_q = static_cast<long double>(max_denominator);
+	long double p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+	long double rest = x;
+	while (true)
+	{
+		const long double a = std::floor(rest);
+		const long double p2 = a * p1 + p0;
+		const long double q2 = a * q1 + q0;
+		if (q2 > max_q || p2 >= limit)
+		{
+			break;
+		}
+		p0 = p1;
+		q0 = q1;
+		p1 = p2;
+		q1 = q2;
+		if (rest == a)
+		{
+			break;
+		}
+		rest = 1 / (rest - a);
+	}
+	long double k = std::floor((max_q - q0) / q1);
+	if (p1 != 0)
+	{
+		k = std::min(k, std::floor((limit - 1 - p0) / p1));
+	}
+	long double p = p1, q = q1;
+	if (k >= 1 && std::fabs(x - (p0 + k * p1) / (q0 + k * q1)) < std::fabs(x - p1 / q1))
+	{
+		p = p0 + k * p1;
+		q = q0 + k * q1;
+	}
+	const T numerator = static_cast<T>(p);
+	return Fraction<T, P>(negative ? -numerator : numerator, static_cast<T>(q));
+}
+
+}
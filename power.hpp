@@ -0,0 +1,30 @@
+#ifndef TOKOX_FRACTIONS_POWER
+#define TOKOX_FRACTIONS_POWER
+
+#include <cstdint>
+#include <cmath>
+#include <concepts>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+#include "fractions.hpp"
+
+namespace tokox
+{
+
+template <Fraction_compatible T, OverflowPolicy P, std::integral E>
+Fraction<T, P> pow (const Fraction<T, P>& f, const E e);
+
+template <Fraction_compatible T, OverflowPolicy P>
+std::optional<Fraction<T, P>> exact_root (const Fraction<T, P>& f, const unsigned n);
+
+template <Fraction_compatible T, OverflowPolicy P>
+	requires std::integral<T>
+Fraction<T, P> root_approx (const Fraction<T, P>& f, const unsigned n, const std::type_identity_t<T> max_denominator);
+
+}
+
+#include "power.cpp"
+
+#endif
@@ -10,24 +10,32 @@
 #include <stdexcept>
 
 #include "fractions.hpp"
+#include "atomic_fraction.hpp"
 
-template <typename T>
-void swap (tokox::Fraction<T>& one, tokox::Fraction<T>& two)
+template <typename T, tokox::OverflowPolicy P>
+void swap (tokox::Fraction<T, P>& one, tokox::Fraction<T, P>& two)
 {
 	one.swap(two);
 }
 
-template <typename T>
-struct std::hash<tokox::Fraction<T>>
+template <typename T, tokox::OverflowPolicy P>
+struct std::hash<tokox::Fraction<T, P>>
 {
-	std::size_t operator() (const tokox::Fraction<T>& f) const
+	std::size_t operator() (const tokox::Fraction<T, P>& f) const
 	{
 		return f.hash();
 	}
 };
 
 template <typename T>
-std::ostream& operator<< (std::ostream& o, const tokox::Fraction<T>& f)
+struct std::atomic<tokox::Fraction<T>> : tokox::atomic_fraction<T>
+{
+	using tokox::atomic_fraction<T>::atomic_fraction;
+	using tokox::atomic_fraction<T>::operator=;
+};
+
+template <typename T, tokox::OverflowPolicy P>
+std::ostream& operator<< (std::ostream& o, const tokox::Fraction<T, P>& f)
 {
 	return o << f.numerator() << '/' << f.denominator();
 }
@@ -55,8 +63,8 @@ private:
 
 }
 
-template <typename T>
-std::istream& operator>> (std::istream& i, tokox::Fraction<T>& f)
+template <typename T, tokox::OverflowPolicy P>
+std::istream& operator>> (std::istream& i, tokox::Fraction<T, P>& f)
 {
 	T v;
 	i >> v;
@@ -80,8 +88,8 @@ std::istream& operator>> (std::istream& i, tokox::Fraction<T>& f)
 	return i;
 }
 
-template <typename T>
-class std::numeric_limits<tokox::Fraction<T>>
+template <typename T, tokox::OverflowPolicy P>
+class std::numeric_limits<tokox::Fraction<T, P>>
 {
 public:
 	static constexpr bool is_specialized = true;
@@ -96,7 +104,7 @@ public:
 	static constexpr std::float_round_style round_style = std::round_indeterminate;
 	static constexpr bool is_iec559 = false;
 	static constexpr bool is_bounded = std::numeric_limits<T>::is_bounded;
-	static constexpr bool is_modulo = false;
+	static constexpr bool is_modulo = P == tokox::OverflowPolicy::wrapping;
 	static constexpr int digits = std::numeric_limits<T>::digits * 2;
 	static constexpr int digits10 = std::numeric_limits<T>::digits10 * 2;
 	static constexpr int max_digits10 = std::numeric_limits<T>::max_digits10 * 2;
@@ -105,72 +113,72 @@ public:
 	static constexpr int min_exponent10 = is_bounded ? std::log10(std::numeric_limits<T>::max()) + 1 : 0;
 	static constexpr int max_exponent = is_bounded ? std::log2(std::numeric_limits<T>::max()) / std::log2(std::numeric_limits<T>::radix) + 1 : 0;
 	static constexpr int max_exponent10 = is_bounded ? std::log10(std::numeric_limits<T>::max()) + 1 : 0;
-	static constexpr bool traps = true;
+	static constexpr bool traps = P == tokox::OverflowPolicy::checked;
 	static constexpr bool tineness_before = false;
 
-	static constexpr tokox::Fraction<T> min () noexcept
+	static constexpr tokox::Fraction<T, P> min () noexcept
 	{
 		if constexpr (is_bounded)
 		{
-			return tokox::Fraction<T>(1, std::numeric_limits<T>::max());
+			return tokox::Fraction<T, P>(1, std::numeric_limits<T>::max());
 		}
 		else
 		{
-			return tokox::Fraction<T>();
+			return tokox::Fraction<T, P>();
 		}
 	}
-	static constexpr tokox::Fraction<T> lowest () noexcept
+	static constexpr tokox::Fraction<T, P> lowest () noexcept
 	{
 		if constexpr (is_bounded)
 		{
-			return tokox::Fraction<T>(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
+			return tokox::Fraction<T, P>(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
 		}
 		else
 		{
-			return tokox::Fraction<T>();
+			return tokox::Fraction<T, P>();
 		}
 	}
-	static constexpr tokox::Fraction<T> max () noexcept
+	static constexpr tokox::Fraction<T, P> max () noexcept
 	{
 		if constexpr (is_bounded)
 		{
-			return tokox::Fraction<T>(std::numeric_limits<T>::max(), 1);
+			return tokox::Fraction<T, P>(std::numeric_limits<T>::max(), 1);
 		}
 		else
 		{
-			return tokox::Fraction<T>();
+			return tokox::Fraction<T, P>();
 		}
 	}
-	static constexpr tokox::Fraction<T> epsilon () noexcept
+	static constexpr tokox::Fraction<T, P> epsilon () noexcept
 	{
 		if constexpr (is_bounded)
 		{
-			return tokox::Fraction<T>(1, std::numeric_limits<T>::max() - 1);
+			return tokox::Fraction<T, P>(1, std::numeric_limits<T>::max() - 1);
 		}
 		else
 		{
-			return tokox::Fraction<T>();
+			return tokox::Fraction<T, P>();
 		}
 	}
-	static constexpr tokox::Fraction<T> round_error () noexcept
+	static constexpr tokox::Fraction<T, P> round_error () noexcept
 	{
-		return tokox::Fraction<T>(0);
+		return tokox::Fraction<T, P>(0);
 	}
-	static constexpr tokox::Fraction<T> infinity () noexcept
+	static constexpr tokox::Fraction<T, P> infinity () noexcept
 	{
-		return tokox::Fraction<T>();
+		return tokox::Fraction<T, P>();
 	}
-	static constexpr tokox::Fraction<T> quiet_NaN () noexcept
+	static constexpr tokox::Fraction<T, P> quiet_NaN () noexcept
 	{
-		return tokox::Fraction<T>();
+		return tokox::Fraction<T, P>();
 	}
-	static constexpr tokox::Fraction<T> signaling_NaN () noexcept
+	static constexpr tokox::Fraction<T, P> signaling_NaN () noexcept
 	{
-		return tokox::Fraction<T>();
+		return tokox::Fraction<T, P>();
 	}
-	static constexpr tokox::Fraction<T> denorm_min () noexcept
+	static constexpr tokox::Fraction<T, P> denorm_min () noexcept
 	{
-		return tokox::Fraction<T>();
+		return tokox::Fraction<T, P>();
 	}
 };
 
@@ -0,0 +1,6 @@
+#include "fractions.hpp"
+
+namespace tokox
+{
+TOKOX_FRACTIONS_INSTANTIATE_ALL()
+}
@@ -0,0 +1,128 @@
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../atomic_fraction.hpp"
+
+static void usage (const char* argv0)
+{
+	std::cerr << "usage: " << argv0 << " [-n updates_per_thread] [-t max_threads]\n"
+		<< "Adds to one shared total from 1, 2, 4, ... max_threads threads (default 64) through a\n"
+		<< "mutex, an atomic_fraction and a sharded_atomic_fraction, and prints million updates per\n"
+		<< "second for Fraction<int32_t> and Fraction<int64_t>.\n";
+}
+
+// Runs body(thread, updates) on every thread at once and returns million
+// updates per second over all of them.
+template <typename Body>
+static double run (const unsigned threads, const std::size_t updates, Body body)
+{
+	std::atomic<unsigned> ready(0);
+	std::atomic<bool> go(false);
+	std::vector<std::thread> workers;
+	for (unsigned t = 0; t < threads; ++t)
+	{
+		workers.emplace_back([&, t]
+		{
+			ready.fetch_add(1);
+			while (!go.load(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+			body(t, updates);
+		});
+	}
+	while (ready.load() != threads)
+	{
+		std::this_thread::yield();
+	}
+	const auto start = std::chrono::steady_clock::now();
+	go.store(true, std::memory_order_release);
+	for (std::thread& w : workers)
+	{
+		w.join();
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return double(threads) * double(updates) / seconds / 1e6;
+}
+
+// The addends cycle through values summing to zero, so the total stays small
+// however long the run is.
+template <typename T>
+static void bench (const std::string& name, const unsigned max_threads, const std::size_t updates)
+{
+	using F = tokox::Fraction<T>;
+	const F addends[] = {F(1, 2), F(1, 3), F(1, 6), F(-1, 2), F(-1, 3), F(-1, 6)};
+	std::cout << name << (tokox::atomic_fraction<T>::is_always_lock_free ? ", lock-free" : ", not lock-free") << '\n'
+		<< std::setw(8) << "threads" << std::setw(12) << "mutex" << std::setw(12) << "atomic" << std::setw(12) << "sharded"
+		<< "  (million updates/s)\n";
+	for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+	{
+		std::mutex mutex;
+		F locked;
+		const double m = run(threads, updates, [&] (const unsigned t, const std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				locked += addends[(t + i) % 6];
+			}
+		});
+		tokox::atomic_fraction<T> shared;
+		const double a = run(threads, updates, [&] (const unsigned t, const std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				shared.fetch_add(addends[(t + i) % 6], std::memory_order_relaxed);
+			}
+		});
+		tokox::sharded_atomic_fraction<T> sharded;
+		const double s = run(threads, updates, [&] (const unsigned t, const std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				sharded.add(addends[(t + i) % 6], std::memory_order_relaxed);
+			}
+		});
+		std::cout << std::setw(8) << threads << std::fixed << std::setprecision(2)
+			<< std::setw(12) << m << std::setw(12) << a << std::setw(12) << s << '\n';
+	}
+}
+
+int main (int argc, char** argv)
+{
+	std::size_t updates = 200000;
+	unsigned max_threads = 64;
+	for (int i = 1; i < argc; i += 2)
+	{
+		const std::string flag = argv[i];
+		if (i + 1 < argc && flag == "-n")
+		{
+			updates = std::strtoul(argv[i + 1], nullptr, 10);
+		}
+		else if (i + 1 < argc && flag == "-t")
+		{
+			max_threads = std::strtoul(argv[i + 1], nullptr, 10);
+		}
+		else
+		{
+			usage(argv[0]);
+			return 2;
+		}
+	}
+	if (updates == 0 || max_threads == 0)
+	{
+		usage(argv[0]);
+		return 2;
+	}
+	bench<int32_t>("Fraction<int32_t>", max_threads, updates);
+	bench<int64_t>("Fraction<int64_t>", max_threads, updates);
+	return 0;
+}
@@ -0,0 +1,403 @@
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../expr.hpp"
+#include "../fractions.hpp"
+#include "../power.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static volatile int64_t sink;
+
+struct Suite
+{
+	const char* name;
+	const char* description;
+	void (*run) (std::size_t repeats);
+};
+
+static void report (const std::string& name, const double nanoseconds, const std::string& note = "")
+{
+	std::cout << "  " << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(2)
+		<< std::setw(10) << nanoseconds << " ns/op";
+	if (!note.empty())
+	{
+		std::cout << "  " << note;
+	}
+	std::cout << '\n';
+}
+
+// Runs f, which performs ops operations, and returns nanoseconds per operation.
+template <typename F>
+static double measure (const std::size_t ops, F&& f)
+{
+	const auto start = Clock::now();
+	f();
+	return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / double(ops);
+}
+
+// Reduced operands with numerators and denominators up to limit.
+template <typename T>
+static std::vector<tokox::Fraction<T>> operands (const std::size_t count, const int64_t limit, const uint64_t seed)
+{
+	std::mt19937_64 rng(seed);
+	std::vector<tokox::Fraction<T>> v;
+	v.reserve(count);
+	while (v.size() < count)
+	{
+		const T n = T(int64_t(rng() % uint64_t(2 * limit + 1)) - limit);
+		const T d = T(int64_t(rng() % uint64_t(limit)) + 1);
+		v.emplace_back(n, d);
+		v.back().reduce();
+	}
+	return v;
+}
+
+static void cross_cancellation (const std::size_t repeats)
+{
+	using F = tokox::Fraction<int64_t>;
+	for (const bool henrici : {false, true})
+	{
+		int64_t terms = 0;
+		const double ns = measure(repeats, [&]
+		{
+			for (std::size_t r = 0; r < repeats; ++r)
+			{
+				F h(0);
+				int64_t i = 1;
+				try
+				{
+					for (;; ++i)
+					{
+						if (henrici)
+						{
+							h.henrici_add(F(1, i));
+						}
+						else
+						{
+							h += F(1, i);
+						}
+					}
+				}
+				catch (tokox::FractionOverflowError<int64_t>&)
+				{
+				}
+				terms = i - 1;
+			}
+		});
+		report(henrici ? "harmonic sum, henrici_add" : "harmonic sum, +=", ns, "per sum, " + std::to_string(terms) + " terms before overflow");
+	}
+
+	const std::vector<F> a = operands<int64_t>(4096, 1000000, 1), b = operands<int64_t>(4096, 1000000, 2);
+	const std::size_t ops = repeats * a.size();
+	const auto pairs = [&] (auto&& op)
+	{
+		return measure(ops, [&]
+		{
+			for (std::size_t r = 0; r < repeats; ++r)
+			{
+				for (std::size_t i = 0; i < a.size(); ++i)
+				{
+					F c = a[i];
+					op(c, b[i]);
+					sink = c.numerator();
+				}
+			}
+		});
+	};
+	report("add then reduce", pairs([] (F& c, const F& x) { c += x; c.reduce(); }));
+	report("henrici_add", pairs([] (F& c, const F& x) { c.henrici_add(x); }));
+	report("mul then reduce", pairs([] (F& c, const F& x) { c *= x; c.reduce(); }));
+	report("knuth_mul", pairs([] (F& c, const F& x) { c.knuth_mul(x); }));
+}
+
+static void expression_rows (const std::size_t repeats)
+{
+	using F = tokox::Fraction<int64_t>;
+	const std::size_t rows = 4096;
+	std::vector<F> results(rows);
+	std::vector<tokox::expr::Status> statuses(rows);
+	const std::pair<const char*, int64_t> cases[] = {{"a*b + c/d", 1000}, {"a*b*c*d*a*b - a/b", 1000000}};
+	for (const auto& [source, limit] : cases)
+	{
+		std::vector<std::vector<F>> columns;
+		for (uint64_t c = 0; c < 4; ++c)
+		{
+			columns.push_back(operands<int64_t>(rows, limit, 10 + c));
+		}
+		const std::vector<std::span<const F>> views(columns.begin(), columns.end());
+		const tokox::expr::Program<int64_t> program(source);
+		const double ns = measure(repeats * rows, [&]
+		{
+			for (std::size_t r = 0; r < repeats; ++r)
+			{
+				program.evaluate(views, results, statuses);
+			}
+		});
+		std::size_t overflow = 0;
+		for (const tokox::expr::Status s : statuses)
+		{
+			overflow += s == tokox::expr::Status::overflow;
+		}
+		report(source, ns, "per row, " + std::to_string(100 * overflow / rows) + "% overflow");
+	}
+}
+
+template <tokox::OverflowPolicy P>
+static void policy_kernels (const std::string& name, const std::size_t repeats)
+{
+	using F = tokox::Fraction<int64_t, P>;
+	std::vector<F> a, b;
+	for (const auto& f : operands<int64_t>(4096, 1000, 3))
+	{
+		a.emplace_back(f);
+	}
+	for (const auto& f : operands<int64_t>(4096, 1000, 4))
+	{
+		b.emplace_back(f);
+	}
+	const std::size_t ops = repeats * a.size();
+	const auto pairs = [&] (auto&& op)
+	{
+		return measure(ops, [&]
+		{
+			for (std::size_t r = 0; r < repeats; ++r)
+			{
+				for (std::size_t i = 0; i < a.size(); ++i)
+				{
+					sink = op(a[i], b[i]);
+				}
+			}
+		});
+	};
+	report(name + " a + b", pairs([] (const F& x, const F& y) { return (x + y).numerator(); }));
+	report(name + " a * b", pairs([] (const F& x, const F& y) { return (x * y).numerator(); }));
+	report(name + " a < b", pairs([] (const F& x, const F& y) { return int64_t(x < y); }));
+	report(name + " a * b + a", pairs([] (const F& x, const F& y) { return (x * y + x).numerator(); }));
+}
+
+static void overflow_policy (const std::size_t repeats)
+{
+	policy_kernels<tokox::OverflowPolicy::checked>("checked", repeats);
+	policy_kernels<tokox::OverflowPolicy::unchecked>("unchecked", repeats);
+	policy_kernels<tokox::OverflowPolicy::wrapping>("wrapping", repeats);
+	policy_kernels<tokox::OverflowPolicy::saturating>("saturating", repeats);
+}
+
+static void power (const std::size_t repeats)
+{
+	using F = tokox::Fraction<int64_t>;
+	const std::vector<F> bases = operands<int64_t>(4096, 50, 5);
+	for (const unsigned e : {3u, 7u, 11u})
+	{
+		const std::size_t ops = repeats * bases.size();
+		const double naive = measure(ops, [&]
+		{
+			for (std::size_t r = 0; r < repeats; ++r)
+			{
+				for (const F& b : bases)
+				{
+					F p(1);
+					for (unsigned i = 0; i < e; ++i)
+					{
+						p *= b;
+					}
+					sink = p.reduce().numerator();
+				}
+			}
+		});
+		const double fast = measure(ops, [&]
+		{
+			for (std::size_t r = 0; r < repeats; ++r)
+			{
+				for (const F& b : bases)
+				{
+					sink = tokox::pow(b, e).numerator();
+				}
+			}
+		});
+		report("loop of *=, exponent " + std::to_string(e), naive);
+		report("pow, exponent " + std::to_string(e), fast);
+	}
+
+	// Roots of perfect powers, against trying every candidate numerator and
+	// denominator with the loop.
+	std::vector<F> cubes;
+	for (const F& b : bases)
+	{
+		cubes.push_back(tokox::pow(b, 3));
+	}
+	const std::size_t ops = repeats * cubes.size();
+	const auto naive_root = [] (int64_t v)
+	{
+		const bool negative = v < 0;
+		v = negative ? -v : v;
+		int64_t k = 0;
+		for (;; ++k)
+		{
+			int64_t p = 1;
+			for (int i = 0; i < 3; ++i)
+			{
+				p *= k;
+			}
+			if (p >= v)
+			{
+				return p == v ? (negative ? -k : k) : int64_t(-1);
+			}
+		}
+	};
+	report("candidate search, cube roots", measure(ops, [&]
+	{
+		for (std::size_t r = 0; r < repeats; ++r)
+		{
+			for (const F& c : cubes)
+			{
+				sink = F(naive_root(c.numerator()), naive_root(c.denominator())).numerator();
+			}
+		}
+	}));
+	report("exact_root, cube roots", measure(ops, [&]
+	{
+		for (std::size_t r = 0; r < repeats; ++r)
+		{
+			for (const F& c : cubes)
+			{
+				sink = tokox::exact_root(c, 3)->numerator();
+			}
+		}
+	}));
+}
+
+// Only successful operations are timed: pairs whose result overflows T are
+// dropped up front.
+template <typename T>
+static void small_type_kernels (const std::string& name, const std::size_t repeats)
+{
+	using F = tokox::Fraction<T>;
+	const int64_t limit = sizeof(T) == 1 ? 11 : 180;
+	const std::vector<F> x = operands<T>(4096, limit, 6), y = operands<T>(4096, limit, 7);
+	const auto pairs = [&] (const std::string& what, auto&& op)
+	{
+		std::vector<F> a, b;
+		for (std::size_t i = 0; i < x.size(); ++i)
+		{
+			try
+			{
+				F c = x[i];
+				op(c, y[i]);
+				a.push_back(x[i]);
+				b.push_back(y[i]);
+			}
+			catch (std::exception&)
+			{
+			}
+		}
+		const double ns = measure(repeats * a.size(), [&]
+		{
+			for (std::size_t r = 0; r < repeats; ++r)
+			{
+				for (std::size_t i = 0; i < a.size(); ++i)
+				{
+					F c = a[i];
+					sink = op(c, b[i]);
+				}
+			}
+		});
+		report(name + " " + what, ns, std::to_string(a.size()) + " pairs");
+	};
+	pairs("a += b", [] (F& c, const F& d) { c += d; return int64_t(c.numerator()); });
+	pairs("a -= b", [] (F& c, const F& d) { c -= d; return int64_t(c.numerator()); });
+	pairs("a *= b", [] (F& c, const F& d) { c *= d; return int64_t(c.numerator()); });
+	pairs("a /= b", [] (F& c, const F& d) { c /= d; return int64_t(c.numerator()); });
+	pairs("a < b", [] (F& c, const F& d) { return int64_t(c < d); });
+	pairs("(a *= b).reduce()", [] (F& c, const F& d) { c *= d; c.reduce(); return int64_t(c.numerator()); });
+}
+
+static void small_types (const std::size_t repeats)
+{
+	std::cout << "  lookup tables " << (tokox::use_lookup_tables<int8_t> ? "on" : "off")
+		<< "; build with -DTOKOX_FRACTIONS_LOOKUP_TABLE_BUDGET=0 for the generic path\n";
+	small_type_kernels<int8_t>("int8_t", repeats);
+	small_type_kernels<int16_t>("int16_t", repeats);
+}
+
+static const Suite suites[] = {
+	{"cross_cancellation", "lazy operators against henrici_add and knuth_mul on Fraction<int64_t>", cross_cancellation},
+	{"overflow_policy", "Fraction<int64_t> kernels on small operands under every OverflowPolicy", overflow_policy},
+	{"power", "pow and exact_root against repeated multiplication on Fraction<int64_t>", power},
+	{"small_types", "Fraction<int8_t> and Fraction<int16_t> operators, table driven or generic", small_types},
+	{"expression_rows", "expr::Program<int64_t> batches with few and with mostly overflowing rows", expression_rows},
+};
+
+static void usage (const char* argv0)
+{
+	std::cerr << "usage: " << argv0 << " [-n repeats] [SUITE...]\n"
+		<< "Runs the named benchmark suites, or all of them, and prints nanoseconds per operation.\n"
+		<< "Suites:\n";
+	for (const Suite& s : suites)
+	{
+		std::cerr << "  " << std::left << std::setw(20) << s.name << s.description << '\n';
+	}
+}
+
+int main (int argc, char** argv)
+{
+	std::size_t repeats = 100;
+	int i = 1;
+	for (; i < argc && argv[i][0] == '-'; i += 2)
+	{
+		const std::string flag = argv[i];
+		if (flag == "-n" && i + 1 < argc)
+		{
+			repeats = std::strtoul(argv[i + 1], nullptr, 10);
+		}
+		else
+		{
+			usage(argv[0]);
+			return 2;
+		}
+	}
+	if (repeats == 0)
+	{
+		usage(argv[0]);
+		return 2;
+	}
+	std::vector<const Suite*> selected;
+	for (; i < argc; ++i)
+	{
+		const Suite* found = nullptr;
+		for (const Suite& s : suites)
+		{
+			if (argv[i] == std::string(s.name))
+			{
+				found = &s;
+			}
+		}
+		if (found == nullptr)
+		{
+			usage(argv[0]);
+			return 2;
+		}
+		selected.push_back(found);
+	}
+	if (selected.empty())
+	{
+		for (const Suite& s : suites)
+		{
+			selected.push_back(&s);
+		}
+	}
+	for (const Suite* s : selected)
+	{
+		std::cout << s->name << ": " << s->description << '\n';
+		s->run(repeats);
+	}
+	return 0;
+}
@@ -0,0 +1,256 @@
+#include <cstdint>
+#include <cstdlib>
+#include <charconv>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../expr.hpp"
+#include "../std_specializations.hpp"
+
+using Value = tokox::Fraction<int64_t>;
+
+static void usage (const char* argv0)
+{
+	std::cerr << "usage: " << argv0 << " [-j threads] [-b batch_rows] [-n result_name] FORMULA\n"
+		<< "Reads CSV with a header line from stdin and writes it to stdout with one more column\n"
+		<< "holding FORMULA evaluated for every row. Cells are integers, decimals or n/d fractions.\n";
+}
+
+static bool parse_integer (std::string_view s, int64_t& v)
+{
+	const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+	return ec == std::errc() && end == s.data() + s.size();
+}
+
+static bool parse_cell (std::string_view s, Value& f)
+{
+	while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+	{
+		s.remove_prefix(1);
+	}
+	while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r'))
+	{
+		s.remove_suffix(1);
+	}
+	try
+	{
+		const std::size_t slash = s.find('/');
+		if (slash != std::string_view::npos)
+		{
+			int64_t n, d;
+			if (!parse_integer(s.substr(0, slash), n) || !parse_integer(s.substr(slash + 1), d))
+			{
+				return false;
+			}
+			f = Value(n, d);
+			return true;
+		}
+		const std::size_t dot = s.find('.');
+		if (dot == std::string_view::npos)
+		{
+			int64_t n;
+			if (!parse_integer(s, n))
+			{
+				return false;
+			}
+			f = Value(n);
+			return true;
+		}
+		const std::string digits = std::string(s.substr(0, dot)) + std::string(s.substr(dot + 1));
+		int64_t n;
+		if (!parse_integer(digits, n))
+		{
+			return false;
+		}
+		int64_t d = 1;
+		for (std::size_t i = dot + 1; i < s.size(); ++i)
+		{
+			if (!tokox::can_mul<int64_t>(d, 10))
+			{
+				return false;
+			}
+			d *= 10;
+		}
+		f = Value(n, d);
+		return true;
+	}
+	catch (std::exception&)
+	{
+		return false;
+	}
+}
+
+static std::vector<std::string_view> split (std::string_view line)
+{
+	std::vector<std::string_view> cells;
+	std::size_t start = 0;
+	while (true)
+	{
+		const std::size_t comma = line.find(',', start);
+		if (comma == std::string_view::npos)
+		{
+			cells.push_back(line.substr(start));
+			return cells;
+		}
+		cells.push_back(line.substr(start, comma - start));
+		start = comma + 1;
+	}
+}
+
+static const char* status_name (tokox::expr::Status s)
+{
+	switch (s)
+	{
+		case tokox::expr::Status::overflow:
+			return "error:overflow";
+		case tokox::expr::Status::division_by_zero:
+			return "error:division_by_zero";
+		default:
+			return "";
+	}
+}
+
+int main (int argc, char** argv)
+{
+	unsigned threads = 1;
+	std::size_t batch_rows = 1 << 16;
+	std::string result_name = "result";
+	int i = 1;
+	for (; i < argc - 1 && argv[i][0] == '-'; i += 2)
+	{
+		const std::string flag = argv[i];
+		if (flag == "-j")
+		{
+			threads = std::strtoul(argv[i + 1], nullptr, 10);
+		}
+		else if (flag == "-b")
+		{
+			batch_rows = std::strtoul(argv[i + 1], nullptr, 10);
+		}
+		else if (flag == "-n")
+		{
+			result_name = argv[i + 1];
+		}
+		else
+		{
+			usage(argv[0]);
+			return 2;
+		}
+	}
+	if (i != argc - 1 || batch_rows == 0)
+	{
+		usage(argv[0]);
+		return 2;
+	}
+
+	std::unique_ptr<tokox::expr::Program<int64_t>> program;
+	try
+	{
+		program = std::make_unique<tokox::expr::Program<int64_t>>(argv[i]);
+	}
+	catch (tokox::expr::ExpressionError& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 2;
+	}
+
+	std::ios::sync_with_stdio(false);
+	std::string header;
+	if (!std::getline(std::cin, header))
+	{
+		std::cerr << "missing CSV header\n";
+		return 2;
+	}
+	if (!header.empty() && header.back() == '\r')
+	{
+		header.pop_back();
+	}
+	const std::vector<std::string_view> names = split(header);
+	std::vector<std::size_t> column_of;
+	for (const std::string& v : program->variables())
+	{
+		std::size_t c = 0;
+		while (c < names.size() && names[c] != v)
+		{
+			++c;
+		}
+		if (c == names.size())
+		{
+			std::cerr << "variable " << v << " is not a CSV column\n";
+			return 2;
+		}
+		column_of.push_back(c);
+	}
+	std::cout << header << ',' << result_name << '\n';
+
+	const std::size_t variables = column_of.size();
+	std::vector<std::string> lines;
+	std::vector<std::vector<Value>> columns(variables);
+	std::vector<std::span<const Value>> views(variables);
+	std::vector<Value> results;
+	std::vector<tokox::expr::Status> statuses;
+	std::vector<char> bad_input;
+	std::string line;
+	bool more = true;
+	while (more)
+	{
+		lines.clear();
+		while (lines.size() < batch_rows && (more = static_cast<bool>(std::getline(std::cin, line))))
+		{
+			if (!line.empty() && line.back() == '\r')
+			{
+				line.pop_back();
+			}
+			lines.push_back(line);
+		}
+		const std::size_t rows = lines.size();
+		if (rows == 0)
+		{
+			break;
+		}
+		for (auto& column : columns)
+		{
+			column.assign(rows, Value());
+		}
+		bad_input.assign(rows, 0);
+		for (std::size_t r = 0; r < rows; ++r)
+		{
+			const std::vector<std::string_view> cells = split(lines[r]);
+			for (std::size_t v = 0; v < variables; ++v)
+			{
+				if (column_of[v] >= cells.size() || !parse_cell(cells[column_of[v]], columns[v][r]))
+				{
+					bad_input[r] = 1;
+				}
+			}
+		}
+		for (std::size_t v = 0; v < variables; ++v)
+		{
+			views[v] = columns[v];
+		}
+		results.assign(rows, Value());
+		statuses.assign(rows, tokox::expr::Status::ok);
+		program->evaluate(views, results, statuses, threads);
+		for (std::size_t r = 0; r < rows; ++r)
+		{
+			std::cout << lines[r] << ',';
+			if (bad_input[r])
+			{
+				std::cout << "error:input";
+			}
+			else if (statuses[r] == tokox::expr::Status::ok)
+			{
+				std::cout << results[r].reduce();
+			}
+			else
+			{
+				std::cout << status_name(statuses[r]);
+			}
+			std::cout << '\n';
+		}
+	}
+	return 0;
+}
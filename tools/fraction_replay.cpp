@@ -0,0 +1,265 @@
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../fractions.hpp"
+#include "../tracing.hpp"
+
+using tokox::trace::Operation;
+using tokox::trace::Record;
+
+enum class Outcome
+{
+	ok,
+	overflow,
+	division_by_zero,
+	other
+};
+
+struct Stats
+{
+	std::vector<uint64_t> latencies;
+	std::size_t overflow = 0;
+	std::size_t division_by_zero = 0;
+	std::size_t other = 0;
+};
+
+static const char* const operation_names[tokox::trace::operation_count] = {
+	"add", "sub", "mul", "div", "mod", "less",
+	"add_integer", "sub_integer", "mul_integer", "div_integer", "mod_integer", "compare_integer"
+};
+
+static void usage (const char* argv0)
+{
+	std::cerr << "usage: " << argv0 << " [-r repeats] TRACE\n"
+		<< "Replays a trace recorded with TOKOX_FRACTIONS_TRACE against this build and reports\n"
+		<< "throughput, latency percentiles and exception rates per operation. Latencies include\n"
+		<< "the cost of reading the clock.\n";
+}
+
+// Operands are built and reduced outside the timed region, so only the
+// operation itself is measured.
+template <typename T, tokox::OverflowPolicy P>
+static Outcome replay (const Record& r, uint64_t& nanoseconds)
+{
+	using Value = tokox::Fraction<T, P>;
+	Value a, b;
+	const T k = T(r.b_numerator);
+	try
+	{
+		a = Value(T(r.a_numerator), T(r.a_denominator));
+		b = Value(T(r.b_numerator), T(r.b_denominator));
+		if (r.a_reduced)
+		{
+			a.reduce();
+		}
+		if (r.b_reduced)
+		{
+			b.reduce();
+		}
+	}
+	catch (std::exception&)
+	{
+		nanoseconds = 0;
+		return Outcome::other;
+	}
+	volatile bool sink = false;
+	Outcome outcome = Outcome::ok;
+	const auto start = std::chrono::steady_clock::now();
+	try
+	{
+		switch (r.operation)
+		{
+			case Operation::add:
+				a += b;
+				break;
+			case Operation::sub:
+				a -= b;
+				break;
+			case Operation::mul:
+				a *= b;
+				break;
+			case Operation::div:
+				a /= b;
+				break;
+			case Operation::mod:
+				a %= b;
+				break;
+			case Operation::less:
+				sink = a < b;
+				break;
+			case Operation::add_integer:
+				a += k;
+				break;
+			case Operation::sub_integer:
+				a -= k;
+				break;
+			case Operation::mul_integer:
+				a *= k;
+				break;
+			case Operation::div_integer:
+				a /= k;
+				break;
+			case Operation::mod_integer:
+				a %= k;
+				break;
+			case Operation::compare_integer:
+				sink = a < k;
+				break;
+		}
+	}
+	catch (tokox::FractionOverflowError<T>&)
+	{
+		outcome = Outcome::overflow;
+	}
+	catch (tokox::FractionDenominatorIsZeroError<T>&)
+	{
+		outcome = Outcome::division_by_zero;
+	}
+	catch (std::exception&)
+	{
+		outcome = Outcome::other;
+	}
+	const auto end = std::chrono::steady_clock::now();
+	(void)sink;
+	nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	return outcome;
+}
+
+template <typename T>
+static Outcome replay (const Record& r, uint64_t& nanoseconds)
+{
+	switch (tokox::OverflowPolicy(r.policy))
+	{
+		case tokox::OverflowPolicy::unchecked:
+			return replay<T, tokox::OverflowPolicy::unchecked>(r, nanoseconds);
+		case tokox::OverflowPolicy::wrapping:
+			return replay<T, tokox::OverflowPolicy::wrapping>(r, nanoseconds);
+		case tokox::OverflowPolicy::saturating:
+			return replay<T, tokox::OverflowPolicy::saturating>(r, nanoseconds);
+		default:
+			return replay<T, tokox::OverflowPolicy::checked>(r, nanoseconds);
+	}
+}
+
+static bool replay (const Record& r, uint64_t& nanoseconds, Outcome& outcome)
+{
+	switch (r.size)
+	{
+		case 1:
+			outcome = replay<int8_t>(r, nanoseconds);
+			return true;
+		case 2:
+			outcome = replay<int16_t>(r, nanoseconds);
+			return true;
+		case 4:
+			outcome = replay<int32_t>(r, nanoseconds);
+			return true;
+		case 8:
+			outcome = replay<int64_t>(r, nanoseconds);
+			return true;
+		default:
+			return false;
+	}
+}
+
+static uint64_t percentile (const std::vector<uint64_t>& sorted, const double p)
+{
+	return sorted[std::min(sorted.size() - 1, std::size_t(p * double(sorted.size())))];
+}
+
+int main (int argc, char** argv)
+{
+	unsigned long repeats = 1;
+	int i = 1;
+	for (; i < argc - 1 && argv[i][0] == '-'; i += 2)
+	{
+		const std::string flag = argv[i];
+		if (flag == "-r")
+		{
+			repeats = std::strtoul(argv[i + 1], nullptr, 10);
+		}
+		else
+		{
+			usage(argv[0]);
+			return 2;
+		}
+	}
+	if (i != argc - 1 || repeats == 0)
+	{
+		usage(argv[0]);
+		return 2;
+	}
+
+	std::vector<Record> records;
+	try
+	{
+		records = tokox::trace::read(argv[i]);
+	}
+	catch (tokox::trace::TraceError& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 2;
+	}
+
+	std::array<Stats, tokox::trace::operation_count> stats;
+	std::size_t skipped = 0;
+	uint64_t busy = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned long rep = 0; rep < repeats; ++rep)
+	{
+		for (const Record& r : records)
+		{
+			uint64_t nanoseconds;
+			Outcome outcome;
+			if (!replay(r, nanoseconds, outcome))
+			{
+				++skipped;
+				continue;
+			}
+			Stats& s = stats[std::size_t(r.operation)];
+			s.latencies.push_back(nanoseconds);
+			busy += nanoseconds;
+			s.overflow += outcome == Outcome::overflow;
+			s.division_by_zero += outcome == Outcome::division_by_zero;
+			s.other += outcome == Outcome::other;
+		}
+	}
+	const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	const std::size_t replayed = records.size() * repeats - skipped;
+	std::cout << "records " << records.size() << ", repeats " << repeats << ", replayed " << replayed
+		<< ", skipped " << skipped << '\n';
+	std::cout << std::fixed << std::setprecision(0)
+		<< "throughput " << (busy == 0 ? 0.0 : double(replayed) * 1e9 / double(busy)) << " ops/s in operations, "
+		<< (wall == 0 ? 0.0 : double(replayed) / wall) << " ops/s overall\n";
+	std::cout << std::left << std::setw(16) << "operation" << std::right
+		<< std::setw(10) << "count" << std::setw(9) << "p50 ns" << std::setw(9) << "p90 ns"
+		<< std::setw(9) << "p99 ns" << std::setw(11) << "max ns"
+		<< std::setw(11) << "overflow%" << std::setw(8) << "zero%" << std::setw(9) << "other%" << '\n';
+	std::cout << std::setprecision(3);
+	for (std::size_t op = 0; op < stats.size(); ++op)
+	{
+		Stats& s = stats[op];
+		if (s.latencies.empty())
+		{
+			continue;
+		}
+		std::sort(s.latencies.begin(), s.latencies.end());
+		const double n = double(s.latencies.size());
+		std::cout << std::left << std::setw(16) << operation_names[op] << std::right
+			<< std::setw(10) << s.latencies.size()
+			<< std::setw(9) << percentile(s.latencies, 0.5) << std::setw(9) << percentile(s.latencies, 0.9)
+			<< std::setw(9) << percentile(s.latencies, 0.99) << std::setw(11) << s.latencies.back()
+			<< std::setw(11) << 100.0 * double(s.overflow) / n
+			<< std::setw(8) << 100.0 * double(s.division_by_zero) / n
+			<< std::setw(9) << 100.0 * double(s.other) / n << '\n';
+	}
+	return 0;
+}
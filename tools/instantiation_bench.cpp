@@ -0,0 +1,26 @@
+#include <cstdint>
+#include <iostream>
+
+#include "../fractions.hpp"
+
+// A typical client translation unit, compiled by instantiation_bench.sh with
+// and without TOKOX_FRACTIONS_EXTERN_TEMPLATES.
+int main ()
+{
+	tokox::Fraction<int64_t> a(0);
+	tokox::Fraction<int32_t> b(1);
+	for (int32_t i = 1; i < 12; ++i)
+	{
+		a += tokox::Fraction<int64_t>(1, i);
+		b *= tokox::Fraction<int32_t>(i + 1, i);
+		b -= tokox::Fraction<int32_t>(1, i + 1);
+		if (b < tokox::Fraction<int32_t>(1, 2))
+		{
+			b /= tokox::Fraction<int32_t>(2, 3);
+		}
+	}
+	a.reduce();
+	b.reduce();
+	std::cout << a.numerator() << '/' << a.denominator() << ' ' << b.numerator() << '/' << b.denominator() << '\n';
+	return 0;
+}
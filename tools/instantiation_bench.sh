@@ -0,0 +1,34 @@
+#!/bin/sh
+# Builds tools/instantiation_bench.cpp with the header instantiating Fraction
+# itself and with TOKOX_FRACTIONS_EXTERN_TEMPLATES against the prebuilt
+# tokox_fractions.cpp, and reports the best compile time of RUNS builds and the
+# text size of the object for both.
+# usage: tools/instantiation_bench.sh [RUNS]   (CXX and CXXFLAGS are honoured)
+set -e
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--std=c++20 -O2}
+runs=${1:-3}
+dir=$(dirname "$0")
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+$CXX $CXXFLAGS -c "$dir/../tokox_fractions.cpp" -o "$tmp/tokox_fractions.o"
+for mode in header extern; do
+	flags=
+	if [ $mode = extern ]; then
+		flags=-DTOKOX_FRACTIONS_EXTERN_TEMPLATES
+	fi
+	best=
+	i=0
+	while [ $i -lt "$runs" ]; do
+		start=$(date +%s.%N)
+		$CXX $CXXFLAGS $flags -c "$dir/instantiation_bench.cpp" -o "$tmp/$mode.o"
+		end=$(date +%s.%N)
+		best=$(awk -v s="$start" -v e="$end" -v b="$best" 'BEGIN { t = e - s; if (b == "" || t < b) b = t; print b }')
+		i=$((i + 1))
+	done
+	text=$(size "$tmp/$mode.o" | awk 'NR == 2 { print $1 }')
+	$CXX $CXXFLAGS "$tmp/$mode.o" "$tmp/tokox_fractions.o" -o "$tmp/$mode"
+	result=$("$tmp/$mode")
+	printf '%-6s compile %.2f s, text %s bytes, prints %s\n' $mode "$best" "$text" "$result"
+done
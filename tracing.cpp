@@ -0,0 +1,243 @@
+#include "tracing.hpp"
+namespace tokox::trace
+{
+
+namespace detail
+{
+
+inline Global& global ()
+{
+	static Global g;
+	return g;
+}
+
+inline ThreadBuffer::ThreadBuffer ()
+{
+	Global& g = global();
+	std::lock_guard<std::mutex> lock(g.mutex);
+	g.buffers.push_back(this);
+}
+
+inline ThreadBuffer::~ThreadBuffer ()
+{
+	std::vector<uint8_t> pending;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.swap(data);
+	}
+	write(pending, generation);
+	Global& g = global();
+	std::lock_guard<std::mutex> lock(g.mutex);
+	std::erase(g.buffers, this);
+}
+
+inline ThreadBuffer& buffer ()
+{
+	thread_local ThreadBuffer b;
+	return b;
+}
+
+inline void put_varint (std::vector<uint8_t>& out, const int64_t v)
+{
+	uint64_t z = (uint64_t(v) << 1) ^ uint64_t(v >> 63);
+	while (z >= 0x80)
+	{
+		out.push_back(uint8_t(z | 0x80));
+		z >>= 7;
+	}
+	out.push_back(uint8_t(z));
+}
+
+inline bool get_varint (const std::vector<uint8_t>& in, std::size_t& pos, int64_t& v)
+{
+	uint64_t z = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		if (pos == in.size())
+		{
+			return false;
+		}
+		const uint8_t byte = in[pos++];
+		z |= uint64_t(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			v = int64_t(z >> 1) ^ -int64_t(z & 1);
+			return true;
+		}
+	}
+	return false;
+}
+
+// The buffer's own lock is never held while taking the global one, so stop()
+// can take both in the other order.
+inline void ThreadBuffer::append (const Record& r)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	const uint64_t current = global().generation.load(std::memory_order_relaxed);
+	if (generation != current)
+	{
+		data.clear();
+		generation = current;
+	}
+	data.push_back(uint8_t(uint8_t(r.operation) | (r.policy << 4) | (r.a_reduced << 6) | (r.b_reduced << 7)));
+	data.push_back(r.size);
+	put_varint(data, r.a_numerator);
+	put_varint(data, r.a_denominator);
+	put_varint(data, r.b_numerator);
+	put_varint(data, r.b_denominator);
+	if (data.size() >= flush_size)
+	{
+		std::vector<uint8_t> pending;
+		pending.swap(data);
+		lock.unlock();
+		write(pending, current);
+	}
+}
+
+inline void write (std::vector<uint8_t>& data, const uint64_t generation)
+{
+	if (data.empty())
+	{
+		return;
+	}
+	Global& g = global();
+	std::lock_guard<std::mutex> lock(g.mutex);
+	if (g.file != nullptr && g.generation.load(std::memory_order_relaxed) == generation)
+	{
+		std::fwrite(data.data(), 1, data.size(), g.file);
+	}
+	data.clear();
+}
+
+}
+
+inline void start (const std::string& path, const uint32_t sample_period)
+{
+	if (sample_period == 0)
+	{
+		throw std::invalid_argument("sample_period is 0 in tokox::trace::start");
+	}
+	detail::Global& g = detail::global();
+	std::lock_guard<std::mutex> lock(g.mutex);
+	if (g.file != nullptr)
+	{
+		throw TraceError("already recording");
+	}
+	g.file = std::fopen(path.c_str(), "wb");
+	if (g.file == nullptr)
+	{
+		throw TraceError("cannot open " + path);
+	}
+	const uint8_t header[12] = {'T', 'O', 'K', 'O', 'X', 'T', 'R', 'C',
+		uint8_t(version), uint8_t(version >> 8), uint8_t(version >> 16), uint8_t(version >> 24)};
+	std::fwrite(header, 1, sizeof(header), g.file);
+	g.period.store(sample_period, std::memory_order_relaxed);
+	g.generation.fetch_add(1, std::memory_order_relaxed);
+	g.enabled.store(true, std::memory_order_release);
+}
+
+// Operations still running in other threads may miss the trace.
+inline void stop ()
+{
+	detail::Global& g = detail::global();
+	std::lock_guard<std::mutex> lock(g.mutex);
+	if (g.file == nullptr)
+	{
+		return;
+	}
+	g.enabled.store(false, std::memory_order_relaxed);
+	const uint64_t generation = g.generation.load(std::memory_order_relaxed);
+	for (detail::ThreadBuffer* b : g.buffers)
+	{
+		std::lock_guard<std::mutex> buffer_lock(b->mutex);
+		if (b->generation == generation)
+		{
+			std::fwrite(b->data.data(), 1, b->data.size(), g.file);
+		}
+		b->data.clear();
+	}
+	std::fclose(g.file);
+	g.file = nullptr;
+}
+
+inline bool recording ()
+{
+	return detail::global().enabled.load(std::memory_order_relaxed);
+}
+
+inline std::vector<Record> read (const std::string& path)
+{
+	std::FILE* file = std::fopen(path.c_str(), "rb");
+	if (file == nullptr)
+	{
+		throw TraceError("cannot open " + path);
+	}
+	std::vector<uint8_t> in;
+	uint8_t chunk[1 << 16];
+	std::size_t got;
+	while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+	{
+		in.insert(in.end(), chunk, chunk + got);
+	}
+	std::fclose(file);
+	if (in.size() < 12 || std::string(in.begin(), in.begin() + 8) != "TOKOXTRC"
+		|| (in[8] | in[9] << 8 | in[10] << 16 | uint32_t(in[11]) << 24) != version)
+	{
+		throw TraceError("bad header in " + path);
+	}
+	std::vector<Record> records;
+	std::size_t pos = 12;
+	while (pos < in.size())
+	{
+		Record r;
+		if (pos + 2 > in.size())
+		{
+			throw TraceError("truncated record in " + path);
+		}
+		const uint8_t head = in[pos++];
+		r.operation = Operation(head & 0x0f);
+		r.policy = (head >> 4) & 0x03;
+		r.a_reduced = (head >> 6) & 1;
+		r.b_reduced = (head >> 7) & 1;
+		r.size = in[pos++];
+		if (std::size_t(r.operation) >= operation_count
+			|| !detail::get_varint(in, pos, r.a_numerator) || !detail::get_varint(in, pos, r.a_denominator)
+			|| !detail::get_varint(in, pos, r.b_numerator) || !detail::get_varint(in, pos, r.b_denominator))
+		{
+			throw TraceError("truncated record in " + path);
+		}
+		records.push_back(r);
+	}
+	return records;
+}
+
+
+
+template <typename T>
+Scope::Scope (const Operation op, const uint8_t policy, const T& an, const T& ad, const bool ar, const T& bn, const T& bd, const bool br)
+{
+	detail::ThreadBuffer& b = detail::buffer();
+	if constexpr (std::integral<T> && sizeof(T) <= 8)
+	{
+		if (b.depth == 0 && detail::global().enabled.load(std::memory_order_relaxed))
+		{
+			if (b.countdown == 0)
+			{
+				b.countdown = detail::global().period.load(std::memory_order_relaxed) - 1;
+				b.append(Record{op, policy, uint8_t(sizeof(T)), ar, br, int64_t(an), int64_t(ad), int64_t(bn), int64_t(bd)});
+			}
+			else
+			{
+				--b.countdown;
+			}
+		}
+	}
+	++b.depth;
+}
+
+inline Scope::~Scope ()
+{
+	--detail::buffer().depth;
+}
+
+}
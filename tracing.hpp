@@ -0,0 +1,129 @@
+#ifndef TOKOX_FRACTIONS_TRACING
+#define TOKOX_FRACTIONS_TRACING
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <atomic>
+#include <concepts>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tokox::trace
+{
+
+class TraceError : public std::runtime_error
+{
+public:
+	TraceError (const std::string& what):
+		std::runtime_error(what + " in tokox::trace")
+	{}
+};
+
+enum class Operation : uint8_t
+{
+	add,
+	sub,
+	mul,
+	div,
+	mod,
+	less,
+	add_integer,
+	sub_integer,
+	mul_integer,
+	div_integer,
+	mod_integer,
+	compare_integer
+};
+
+inline constexpr std::size_t operation_count = 12;
+
+// One traced operation: a op b, with b an integer (denominator 1) for the
+// *_integer operations. policy is the OverflowPolicy and size the sizeof of
+// the Fraction's type.
+struct Record
+{
+	Operation operation;
+	uint8_t policy;
+	uint8_t size;
+	bool a_reduced;
+	bool b_reduced;
+	int64_t a_numerator;
+	int64_t a_denominator;
+	int64_t b_numerator;
+	int64_t b_denominator;
+};
+
+// Traces are "TOKOXTRC", a 4 byte little endian version and then per record
+// one byte with the operation, the policy and both reduced flags, one byte
+// with the size and the four operand values as zigzag LEB128 varints.
+inline constexpr uint32_t version = 1;
+
+void start (const std::string& path, const uint32_t sample_period = 1);
+void stop ();
+bool recording ();
+
+std::vector<Record> read (const std::string& path);
+
+namespace detail
+{
+
+struct ThreadBuffer;
+
+struct Global
+{
+	std::mutex mutex;
+	std::FILE* file = nullptr;
+	std::atomic<bool> enabled{false};
+	std::atomic<uint32_t> period{1};
+	std::atomic<uint64_t> generation{0};
+	std::vector<ThreadBuffer*> buffers;
+};
+
+Global& global ();
+
+struct ThreadBuffer
+{
+	ThreadBuffer ();
+	~ThreadBuffer ();
+
+	void append (const Record& r);
+
+	std::mutex mutex;
+	std::vector<uint8_t> data;
+	uint64_t generation = 0;
+	uint32_t countdown = 0;
+	unsigned depth = 0;
+
+	static constexpr std::size_t flush_size = 1 << 16;
+};
+
+ThreadBuffer& buffer ();
+
+void write (std::vector<uint8_t>& data, const uint64_t generation);
+
+}
+
+// Records the operands of the outermost traced operation of a thread, so an
+// operation implemented with other operations is one record; every
+// sample_period-th of them per thread is kept. Fractions of other than builtin
+// integers up to 64 bits are not recorded.
+class Scope
+{
+public:
+	template <typename T>
+	Scope (const Operation op, const uint8_t policy, const T& an, const T& ad, const bool ar, const T& bn, const T& bd, const bool br);
+	~Scope ();
+
+	Scope (const Scope&) = delete;
+	Scope& operator= (const Scope&) = delete;
+};
+
+}
+
+#include "tracing.cpp"
+
+#endif